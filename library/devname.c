@@ -26,6 +26,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
 #include "misc.h"
 #include "devname.h"
@@ -298,6 +299,76 @@ static int link_name(char *restrict const buf, unsigned maj, unsigned min, int p
   return 1;
 }
 
+/* Remember those names already found, since otherwise each process with a
+ * tty costs us some stat() and readlink() calls. Should /dev or /dev/pts be
+ * changed the whole cache is discarded, but we only check once a second.
+ */
+#define TTY_CACHE_SIZE 256  // must be a power of 2
+
+typedef struct tty_cache_node {
+  struct tty_cache_node *next;
+  unsigned dev;
+  char name[TTY_NAME_SIZE];
+} tty_cache_node;
+
+static __thread tty_cache_node *tty_cache[TTY_CACHE_SIZE];
+static __thread struct timespec tty_cache_stamp[2];
+static __thread time_t tty_cache_when;
+
+static void cache_free(void){
+  tty_cache_node *tcn;
+  int i;
+  for(i = 0; i < TTY_CACHE_SIZE; i++){
+    while((tcn = tty_cache[i])){
+      tty_cache[i] = tcn->next;
+      free(tcn);
+    }
+  }
+}
+
+static void cache_check(void){
+  static const char *const dirs[] = { "/dev", "/dev/pts" };
+  struct stat sbuf;
+  time_t now = time(NULL);
+  int i, stale = 0;
+  if(now == tty_cache_when) return;
+  tty_cache_when = now;
+  for(i = 0; i < 2; i++){
+    if(stat(dirs[i], &sbuf) < 0) memset(&sbuf, 0, sizeof sbuf);
+    if(sbuf.st_mtim.tv_sec != tty_cache_stamp[i].tv_sec
+    || sbuf.st_mtim.tv_nsec != tty_cache_stamp[i].tv_nsec){
+      tty_cache_stamp[i] = sbuf.st_mtim;
+      stale = 1;
+    }
+  }
+  if(!stale) return;
+  cache_free();
+}
+
+#define CACHE_HASH(dev) (((dev) ^ ((dev) >> 8)) & (TTY_CACHE_SIZE - 1))
+
+static int cache_name(char *restrict const buf, unsigned dev){
+  tty_cache_node *tcn;
+  cache_check();
+  for(tcn = tty_cache[CACHE_HASH(dev)]; tcn; tcn = tcn->next){
+    if(tcn->dev != dev) continue;
+    strcpy(buf, tcn->name);
+    return 1;
+  }
+  return 0;
+}
+
+static void cache_save(const char *restrict const buf, unsigned dev){
+  tty_cache_node *tcn;
+  if(!(tcn = malloc(sizeof(tty_cache_node)))) return;
+  tcn->dev = dev;
+  strcpy(tcn->name, buf);
+  tcn->next = tty_cache[CACHE_HASH(dev)];
+  tty_cache[CACHE_HASH(dev)] = tcn;
+}
+
+#undef CACHE_HASH
+
 #ifdef USE_PROC_CTTY
 /* Cygwin keeps the name to the controlling tty in a virtual file called
    /proc/PID/ctty, including a trailing LF (sigh). */
@@ -333,14 +404,17 @@ unsigned dev_to_tty(char *restrict ret, unsigned chop, dev_t dev_t_dev, int pid,
   if(  ctty_name(tmp, pid                                        )) goto abbrev;
 #endif
   if(dev == 0u) goto no_tty;
-  if(driver_name(tmp, major(dev), minor(dev)               )) goto abbrev;
-  if(  link_name(tmp, major(dev), minor(dev), pid, "fd/2"  )) goto abbrev;
-  if( guess_name(tmp, major(dev), minor(dev)               )) goto abbrev;
-  if(  link_name(tmp, major(dev), minor(dev), pid, "fd/255")) goto abbrev;
+  if( cache_name(tmp, dev                                  )) goto abbrev;
+  if(driver_name(tmp, major(dev), minor(dev)               )) goto found;
+  if(  link_name(tmp, major(dev), minor(dev), pid, "fd/2"  )) goto found;
+  if( guess_name(tmp, major(dev), minor(dev)               )) goto found;
+  if(  link_name(tmp, major(dev), minor(dev), pid, "fd/255")) goto found;
   // fall through if unable to find a device file
 no_tty:
   strcpy(ret, chop >= 1 ? "?" : "");
   return 1;
+found:
+  cache_save(tmp, dev);
 abbrev:
   if((flags&ABBREV_DEV) && !strncmp(tmp,"/dev/",5) && tmp[5]) tmp += 5;
   if((flags&ABBREV_TTY) && !strncmp(tmp,"tty",  3) && tmp[3]) tmp += 3;
@@ -362,3 +436,19 @@ abbrev:
   *ret = '\0';
   return i;
 }
+
+
+/* release this thread's driver map and name cache (as a thread ends) */
+void dev_to_tty_free(void) {
+  tty_map_node *tmn;
+  if(tty_map != (tty_map_node *)-1){
+    while((tmn = tty_map)){
+      tty_map = tmn->next;
+      free(tmn);
+    }
+  }
+  tty_map = NULL;
+  cache_free();
+  memset(tty_cache_stamp, 0, sizeof tty_cache_stamp);
+  tty_cache_when = 0;
+}
@@ -50,6 +50,7 @@
 #define SYSBLOCK_DIR        "/sys/block"
 
 #define STACKS_INCR         64           // amount reap stack allocations grow
+#define HASH_INIT           64           // initial dev node hash table size
 #define STR_COMPARE         strverscmp
 
 /* ----------------------------------------------------------------------- +
@@ -83,6 +84,7 @@ struct dev_node {
     struct dev_data new;
     struct dev_data old;
     struct dev_node *next;
+    struct dev_node *hnext;            // next in this name's hash chain
 };
 
 struct stacks_extent {
@@ -111,6 +113,10 @@ struct diskstats_info {
     time_t old_stamp;                  // previous read seconds
     time_t new_stamp;                  // current read seconds
     struct dev_node *nodes;            // dev nodes anchor
+    struct dev_node *nodes_tail;       // dev nodes end (for a quick add)
+    struct dev_node **hash;            // dev nodes, as hashed by name
+    unsigned hash_size;                // number of hash chains (power of 2)
+    unsigned nodes_total;              // number of dev nodes (for rehash)
     struct ext_support select_ext;     // supports concurrent select/reap
     struct ext_support fetch_ext;      // supports concurrent select/reap
     struct fetch_support fetch;        // support for procps_diskstats_reap
@@ -283,17 +289,55 @@ enum diskstats_item DISKSTATS_logical_end = MAXTABLE(Item_table);
 // ___ Private Functions ||||||||||||||||||||||||||||||||||||||||||||||||||||||
 // --- dev_node specific support ----------------------------------------------
 
+static inline struct dev_node **node_bucket (
+        struct diskstats_info *info,
+        const char *name)
+{
+    unsigned hash = 2166136261u;       // the FNV-1a algorithm
+
+    while (*name)
+        hash = (hash ^ (unsigned char)*name++) * 16777619u;
+    return &info->hash[hash & (info->hash_size - 1)];
+} // end: node_bucket
+
+
 static struct dev_node *node_add (
         struct diskstats_info *info,
         struct dev_node *this)
 {
-    struct dev_node *prev, *walk;
+    struct dev_node *walk, **bucket;
+#ifdef ALPHABETIC_NODES
+    struct dev_node *prev;
+#endif
+
+    // keep chains short, rehashing all nodes when we've doubled in size
+    if (info->nodes_total >= info->hash_size) {
+        unsigned size = info->hash_size ? info->hash_size * 2 : HASH_INIT;
+        struct dev_node **hash;
+
+        if (!(hash = calloc(size, sizeof(void *))))
+            return NULL;
+        free(info->hash);
+        info->hash = hash;
+        info->hash_size = size;
+        for (walk = info->nodes; walk; walk = walk->next) {
+            bucket = node_bucket(info, walk->name);
+            walk->hnext = *bucket;
+            *bucket = walk;
+        }
+    }
+    bucket = node_bucket(info, this->name);
+    this->hnext = *bucket;
+    *bucket = this;
+    info->nodes_total++;
 
 #ifdef ALPHABETIC_NODES
     if (!info->nodes
     || (STR_COMPARE(this->name, info->nodes->name) < 0)) {
         this->next = info->nodes;
         info->nodes = this;
+        if (!this->next)
+            info->nodes_tail = this;
         return this;
     }
     prev = info->nodes;
@@ -306,17 +350,15 @@ static struct dev_node *node_add (
     }
     prev->next = this;
     this->next = walk;
+    if (!walk)
+        info->nodes_tail = this;
 #else
+    this->next = NULL;
     if (!info->nodes)
         info->nodes = this;
-    else {
-        walk = info->nodes;
-        do {
-            prev = walk;
-            walk = walk->next;
-        } while (walk);
-        prev->next = this;
-    }
+    else
+        info->nodes_tail->next = this;
+    info->nodes_tail = this;
 #endif
     return this;
 } // end: node_add
@@ -352,16 +394,26 @@ static struct dev_node *node_cut (
         struct diskstats_info *info,
         struct dev_node *this)
 {
-    struct dev_node *node = info->nodes;
+    struct dev_node *node = info->nodes, **bucket;
 
     if (this) {
+        bucket = node_bucket(info, this->name);
+        while (*bucket != this)
+            bucket = &(*bucket)->hnext;
+        *bucket = this->hnext;
+        info->nodes_total--;
+
         if (this == node) {
             info->nodes = node->next;
+            if (!info->nodes)
+                info->nodes_tail = NULL;
             return this;
         }
         do {
             if (this == node->next) {
                 node->next = node->next->next;
+                if (!node->next)
+                    info->nodes_tail = node;
                 return this;
             }
             node = node->next;
@@ -375,12 +427,14 @@ static struct dev_node *node_get (
         struct diskstats_info *info,
         const char *name)
 {
-    struct dev_node *node = info->nodes;
+    struct dev_node *node = NULL;
 
+    if (info->hash_size)
+        node = *node_bucket(info, name);
     while (node) {
         if (strcmp(name, node->name) == 0)
             break;
-        node = node->next;
+        node = node->hnext;
     }
     if (node) {
         /* if this disk or partition has somehow gotten stale, we'll lose
@@ -409,7 +463,10 @@ static int node_update (
         // let's not distort the deltas when a new node is created ...
         memcpy(&target->old, &target->new, sizeof(struct dev_data));
         node_classify(target);
-        node_add(info, target);
+        if (!node_add(info, target)) {
+            free(target);
+            return 0;
+        }
         return 1;
     }
     // remember history from last time around ...
@@ -417,6 +474,7 @@ static int node_update (
     // preserve some stuff from the existing node struct ...
     source->type = target->type;
     source->next = target->next;
+    source->hnext = target->hnext;
     // finally 'update' the existing node struct ...
     memcpy(target, source, sizeof(struct dev_node));
     return 1;
@@ -792,6 +850,7 @@ PROCPS_EXPORT int procps_diskstats_unref (
             node = p->next;
             free(p);
         }
+        free((*info)->hash);
         if ((*info)->select_ext.extents)
             diskstats_extents_free_all((&(*info)->select_ext));
         if ((*info)->select_ext.items)
@@ -6,5 +6,6 @@
 #define ABBREV_PTS  4     /* remove pts/          */
 
 unsigned dev_to_tty(char *__restrict ret, unsigned chop, dev_t dev_t_dev, int pid, unsigned int flags);
+void dev_to_tty_free(void);
 
 #endif
@@ -0,0 +1,52 @@
+/*
+ * keyorder.h - remember the key order of a /proc 'key value' file
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef PROCPS_KEYORDER_H
+#define PROCPS_KEYORDER_H
+
+#include <search.h>
+
+struct keyorder_line {
+    char *key;                 // as hashed, else our own copy (when unknown)
+    void *data;                // that hash entry's data, NULL if unknown
+};
+
+struct keyorder {
+    struct keyorder_line *lines;
+    int alloc;
+};
+
+/*
+ * find the hsearch_r 'data' for the key on line 'n' of a /proc file,
+ * trying the key seen on that same line during the prior read first
+ *   data:   NULL is returned here for a key the hash doesn't know
+ *
+ * we return 0 on success, 1 on malloc failure!
+ */
+
+int keyorder_find (
+        struct keyorder *order,
+        int n,
+        const char *key,
+        struct hsearch_data *hashtab,
+        void **data);
+
+void keyorder_free (
+        struct keyorder *order);
+
+#endif
@@ -45,6 +45,10 @@ enum pids_item {
     PIDS_CMD,               //      str        stat: comm or status: Name
     PIDS_CMDLINE,           //      str        cmdline
     PIDS_CMDLINE_V,         //     strv        cmdline, as *str[]
+    PIDS_CTXSW_INVOL,       //   ul_int        status: nonvoluntary_ctxt_switches
+    PIDS_CTXSW_INVOL_DELTA, //   ul_int        derived from CTXSW_INVOL
+    PIDS_CTXSW_VOL,         //   ul_int        status: voluntary_ctxt_switches
+    PIDS_CTXSW_VOL_DELTA,   //   ul_int        derived from CTXSW_VOL
     PIDS_DOCKER_ID,         //      str        derived from CGROUP '/docker-' (abbreviated hash)
     PIDS_DOCKER_ID_64,      //      str        derived from CGROUP '/docker-' (full hash)
     PIDS_ENVIRON,           //      str        environ
@@ -83,12 +87,16 @@ enum pids_item {
     PIDS_ID_TID,            //    s_int        from /proc/<pid>/task/<tid>
     PIDS_ID_TPGID,          //    s_int        stat: tty_pgrp
     PIDS_IO_READ_BYTES,     //   ul_int        io: read_bytes
+    PIDS_IO_READ_BYTES_DELTA, // ul_int        derived from IO_READ_BYTES
     PIDS_IO_READ_CHARS,     //   ul_int        io: rchar
     PIDS_IO_READ_OPS,       //   ul_int        io: syscr
+    PIDS_IO_READ_OPS_DELTA, //   ul_int        derived from IO_READ_OPS
     PIDS_IO_WRITE_BYTES,    //   ul_int        io: write_bytes
+    PIDS_IO_WRITE_BYTES_DELTA, // ul_int       derived from IO_WRITE_BYTES
     PIDS_IO_WRITE_CBYTES,   //   ul_int        io: cancelled_write_bytes
     PIDS_IO_WRITE_CHARS,    //   ul_int        io: wchar
     PIDS_IO_WRITE_OPS,      //   ul_int        io: syscw
+    PIDS_IO_WRITE_OPS_DELTA, //  ul_int        derived from IO_WRITE_OPS
     PIDS_LXCNAME,           //      str        derived from CGROUP 'lxc.payload'
     PIDS_MEM_CODE,          //   ul_int        derived from MEM_CODE_PGS, as KiB
     PIDS_MEM_CODE_PGS,      //   ul_int        statm: trs
@@ -241,12 +249,48 @@ struct pids_fetch {
     struct pids_stack **stacks;
 };
 
+struct pids_hist_stats {
+    unsigned tasks;                    // hashed by the latest reap or select
+    unsigned slots;                    // size of that hash table
+    unsigned resizes;                  // how often tables grew or shrank
+    unsigned probes_max;               // longest lookup (1 is ideal)
+    unsigned long probes_total;        // all lookups (average = / tasks)
+    unsigned long bytes;               // all memory used for history
+};
+
+struct pids_column {
+    enum pids_item item;
+    union {
+        signed char        *s_ch;
+        signed int         *s_int;
+        unsigned int       *u_int;
+        unsigned long      *ul_int;
+        unsigned long long *ull_int;
+        char              **str;
+        char             ***strv;
+        double             *real;
+    } result;
+};
+
+struct pids_columns {
+    struct pids_counts *counts;
+    struct pids_stack **stacks;        // the rows those columns came from
+    int numrows;                       // the length of every column
+    int numcols;                       // one for each item, in stack order
+    struct pids_column *cols;
+};
+
 struct pids_info;
 
+typedef int (*pids_filter_t)(struct pids_stack *stack, void *data);
+
 
 #define PIDS_VAL( relative_enum, type, stack ) \
     stack -> head [ relative_enum ] . result . type
 
+#define PIDS_COL( relative_enum, type, columns ) \
+    columns -> cols [ relative_enum ] . result . type
+
 
 int procps_pids_new   (struct pids_info **info, enum pids_item *items, int numitems);
 int procps_pids_ref   (struct pids_info  *info);
@@ -264,6 +308,10 @@ struct pids_fetch *procps_pids_reap (
     struct pids_info *info,
     enum pids_fetch_type which);
 
+struct pids_columns *procps_pids_reap_columns (
+    struct pids_info *info,
+    enum pids_fetch_type which);
+
 int procps_pids_reset (
     struct pids_info *info,
     enum pids_item *newitems,
@@ -275,6 +323,21 @@ struct pids_fetch *procps_pids_select (
     int numthese,
     enum pids_select_type which);
 
+struct pids_fetch *procps_pids_select_sticky (
+    struct pids_info *info,
+    unsigned *these,
+    int numthese,
+    enum pids_select_type which);
+
+int procps_pids_filter (
+    struct pids_info *info,
+    pids_filter_t func,
+    void *data);
+
+int procps_pids_borrow (
+    struct pids_info *info,
+    int yes);
+
 struct pids_stack **procps_pids_sort (
     struct pids_info *info,
     struct pids_stack *stacks[],
@@ -282,6 +345,18 @@ struct pids_stack **procps_pids_sort (
     enum pids_item sortitem,
     enum pids_sort_order order);
 
+struct pids_stack **procps_pids_topk (
+    struct pids_info *info,
+    struct pids_stack *stacks[],
+    int numstacked,
+    int k,
+    enum pids_item sortitem,
+    enum pids_sort_order order);
+
+int procps_pids_hist_stats (
+    struct pids_info *info,
+    struct pids_hist_stats *stats);
+
 
 #ifdef XTRA_PROCPS_DEBUG
 # include "xtra-procps-debug.h"
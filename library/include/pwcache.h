@@ -34,5 +34,6 @@
 
 char *pwcache_get_user(uid_t uid);
 char *pwcache_get_group(gid_t gid);
+void pwcache_free(void);
 
 #endif
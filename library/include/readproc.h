@@ -67,6 +67,13 @@ typedef struct proc_t {
         pcpu,           // stat (special)  elapsed tics for %CPU usage calculation
         maj_delta,      // stat (special)  major page faults since last update
         min_delta;      // stat (special)  minor page faults since last update
+    unsigned long       // next 6 fields are NOT filled in by readproc
+        read_bytes_delta,  // io (special)    read_bytes since last update
+        write_bytes_delta, // io (special)    write_bytes since last update
+        syscr_delta,    // io (special)    syscr since last update
+        syscw_delta,    // io (special)    syscw since last update
+        nvcsw_delta,    // status (special) voluntary context switches since last update
+        nivcsw_delta;   // status (special) involuntary context switches since last update
     char
         // Linux 2.1.7x and up have 64 signals. Allow 64, plus '\0' and padding.
         signal[18],     // status          mask of pending signals
@@ -110,6 +117,8 @@ typedef struct proc_t {
         vm_swap,        // status          based on linux-2.6.34 "swap ents" (as kb)
         vm_exe,         // status          equals 'trs' (as kb)
         vm_lib,         // status          total, not just used, library pages (as kb)
+        nvcsw,          // status          voluntary context switches
+        nivcsw,         // status          involuntary context switches
         vsize,          // stat            number of pages of virtual memory ...
         rss_rlim,       // stat            resident set size limit?
         flags,          // stat            kernel flags for the process
@@ -203,6 +212,8 @@ typedef struct proc_t {
         autogrp_id,     // autogroup       autogroup number (id)
         autogrp_nice,   // autogroup       autogroup nice value
         fds;            // fd              number of open files
+    struct proc_arena
+        *arena;         // (special)       if any, owner of the cmd, cmdline, cgroup, etc strings
 } proc_t;
 
 // PROCTAB: data structure holding the persistent information readproc needs
@@ -229,6 +240,19 @@ typedef struct PROCTAB {
     int         i;  // generic
     int         hide_kernel;  // getenv LIBPROC_HIDE_KERNEL was set
     unsigned    flags;
+    int(*prefilter)(void *, proc_t *__restrict const); // optional veto after 'stat'
+    void       *prefilter_data;  // passed back to the above
+    int         vetoed;  // simple_readtask rejection was via prefilter
+    int         listed_tgids;  // PROC_PID list came from /proc itself
+    unsigned    plan;       // the files wanted, see 'read plan' in readproc.c
+    int         plan_kept;  // with PROC_PID, fds are kept during this scan
+    struct plan_fds *planfds;  // any fds kept open for the current pid
+    pid_t      *pids_head;  // the PROC_PID list, as passed to openproc
+    int         sticky;     // with PROC_PID, stickyproc was called
+    int         sticky_num; // the number of pids in that list
+    struct sticky_pid *sticky_pids;    // what's been learned for each pid
+    struct pollfd *sticky_polls;       // with a pidfd for each of them
+    struct proc_arena *arena;  // optional, given to each proc_t that's read
 } PROCTAB;
 
 
@@ -308,7 +332,22 @@ proc_t *readproc(PROCTAB *__restrict const PT, proc_t *__restrict p);
 proc_t *readeither(PROCTAB *__restrict const PT, proc_t *__restrict x);
 int look_up_our_self(void);
 void closeproc(PROCTAB *PT);
-char **vectorize_this_str(const char *src);
+void readproc_free(void);
+// For a PROC_PID table not yet read, stickyproc() asks that the /proc fds,
+// tgid and a pidfd learned for each pid be kept across calls to rewindproc(),
+// which then restarts the scan. Returns 0 (with errno) upon any failure.
+int stickyproc(PROCTAB *PT);
+void rewindproc(PROCTAB *PT);
+char **vectorize_this_str(struct proc_arena *arena, const char *src);
+
+// A proc_arena holds the strings of many proc_t (see PROCTAB.arena), all of
+// which are released together by arena_reset() or arena_free(). The others
+// also accept a NULL arena, using the heap (so free() is then appropriate).
+struct proc_arena *arena_new(void);
+void arena_reset(struct proc_arena *arena);
+void arena_free(struct proc_arena *arena);
+void *arena_alloc(struct proc_arena *arena, size_t size);
+char *arena_strdup(struct proc_arena *arena, const char *str);
 
 struct utlbuf_s;
 struct docker_ids;
@@ -0,0 +1,86 @@
+/*
+ * keyorder.c - remember the key order of a /proc 'key value' file
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <search.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "keyorder.h"
+
+#define KEYORDER_GROW  64
+
+/*
+ * The layout of files like /proc/meminfo and /proc/vmstat seldom changes,
+ * so a key is first compared with whatever was on that line last time. |
+ * Only lines which changed are hashed. A key the hash didn't know gets |
+ * remembered too (as our own copy), so it's never hashed again either. |
+ */
+
+int keyorder_find (
+        struct keyorder *order,
+        int n,
+        const char *key,
+        struct hsearch_data *hashtab,
+        void **data)
+{
+    static __thread ENTRY e;   // keep coverity off our backs (e.data)
+    struct keyorder_line *line;
+    ENTRY *ep;
+
+    if (n < order->alloc
+    && order->lines[n].key && !strcmp(order->lines[n].key, key)) {
+        *data = order->lines[n].data;
+        return 0;
+    }
+    if (n >= order->alloc) {
+        if (!(line = realloc(order->lines, sizeof(struct keyorder_line) * (n + KEYORDER_GROW))))
+            return 1;
+        memset(line + order->alloc, 0, sizeof(struct keyorder_line) * (n + KEYORDER_GROW - order->alloc));
+        order->lines = line;
+        order->alloc = n + KEYORDER_GROW;
+    }
+    line = &order->lines[n];
+    if (line->key && !line->data)
+        free(line->key);
+    line->key = NULL;
+    line->data = NULL;
+
+    e.key = (char *)key;
+    if (hsearch_r(e, FIND, &ep, hashtab)) {
+        line->key = ep->key;
+        line->data = ep->data;
+    } else
+        // should this fail, we'll simply hash that line again next time
+        line->key = strdup(key);
+    *data = line->data;
+    return 0;
+} // end: keyorder_find
+
+
+void keyorder_free (
+        struct keyorder *order)
+{
+    int i;
+
+    for (i = 0; i < order->alloc; i++)
+        if (order->lines[i].key && !order->lines[i].data)
+            free(order->lines[i].key);
+    free(order->lines);
+    order->lines = NULL;
+    order->alloc = 0;
+} // end: keyorder_free
@@ -32,6 +32,7 @@
 #include <sys/types.h>
 
 #include "procps-private.h"
+#include "keyorder.h"
 #include "meminfo.h"
 
 
@@ -138,6 +139,7 @@ struct meminfo_info {
     enum meminfo_item *items;
     struct stacks_extent *extents;
     struct hsearch_data hashtab;
+    struct keyorder order;     // last read's keys, in order (a fast path)
     struct meminfo_result get_this;
     time_t sav_secs;
 };
@@ -663,8 +665,9 @@ static int meminfo_read_failed (
  #define mHr(f) info->hist.new. f
     char buf[MEMINFO_BUFF];
     char *head, *tail;
-    int size;
+    int n, size;
     unsigned long *valptr;
+    void *data;
     signed long mem_used;
 
     // remember history from last time around
@@ -703,18 +706,13 @@ static int meminfo_read_failed (
 
     head = buf;
 
-    for (;;) {
-        static __thread ENTRY e;  // keep coverity off our backs (e.data)
-        ENTRY *ep;
-
+    for (n = 0; ; n++) {
         if (!(tail = strchr(head, ':')))
             break;
         *tail = '\0';
-        valptr = NULL;
-
-        e.key = head;
-        if (hsearch_r(e, FIND, &ep, &info->hashtab))
-            valptr = ep->data;
+        if (keyorder_find(&info->order, n, head, &info->hashtab, &data))
+            return 1;
+        valptr = data;
         head = tail + 1;
         if (valptr)
             *valptr = strtoul(head, NULL, 10);
@@ -901,6 +899,7 @@ PROCPS_EXPORT int procps_meminfo_unref (
         if ((*info)->items)
             free((*info)->items);
         hdestroy_r(&(*info)->hashtab);
+        keyorder_free(&(*info)->order);
 
         free(*info);
         *info = NULL;
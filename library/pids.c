@@ -20,9 +20,13 @@
  */
 
 #include <ctype.h>
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -49,6 +53,7 @@
 #define STACKS_GROW  128               // amount reap stack allocations grow
 #define NEWOLD_INIT  1024              // amount for initial hist allocation
 #define NEWOLD_GROW  128               // amt by which hist allocations grow
+#define WORKERS_MAX  64                // most LIBPROC_REAP_THREADS honored
 
 /* ------------------------------------------------------------------------- +
    this provision can be used to ensure that our Item_table was synchronized |
@@ -73,6 +78,13 @@ struct fetch_support {
     struct pids_counts counts;         // actual counts pointed to by 'results'
 };
 
+struct column_support {
+    struct pids_columns results;       // rows + columns for return to caller
+    int n_alloc_cols;                  // number of results.cols allocated
+    void *values;                      // storage for every column's values
+    size_t n_alloc_values;             // bytes of the above allocated
+};
+
 typedef void (*SET_t)(struct pids_info *, struct pids_result *, proc_t *);
 
 struct pids_info {
@@ -82,6 +94,7 @@ struct pids_info {
     struct stacks_extent *extents;     // anchor for all resettable extents
     struct stacks_extent *otherexts;   // anchor for invariant extents // <=== currently unused
     struct fetch_support fetch;        // support for procps_pids_reap, select, fatal
+    struct column_support columns;     // support for procps_pids_reap_columns
     int history_yes;                   // need historical data
     struct history_info *hist;         // pointer to historical support data
     proc_t*(*read_something)(PROCTAB*, proc_t*); // readproc/readeither via which
@@ -99,6 +112,21 @@ struct pids_info {
     SET_t *func_array;                 // extracted Item_table 'setsfunc' pointers
     int containers_yes;                // need to call pids_containers_check
     unsigned *select_ids;              // copy of user 'these' (pids/uids)
+    pids_filter_t filter_func;         // optional user 'stat' only predicate
+    void *filter_data;                 // user data passed to the above
+    SET_t *filter_array;               // 'setsfunc' pointers for cheap items
+    struct stacks_extent *filter_ext;  // for that predicate (also within 'extents')
+    int reap_threads;                  // from LIBPROC_REAP_THREADS, if at least 2
+    struct reap_pool *pool;            // persistent workers for a parallel reap
+    PROCTAB *sticky_PT;                // oldlib interface kept by 'select_sticky'
+    unsigned *sticky_ids;              // its copy of user 'these' (pids only)
+    int sticky_num;                    // the number of those ids
+    unsigned sticky_flags;             // plus the flags it was opened with
+    struct proc_arena *arena;          // owns the arena strings of a fetch
+    struct proc_arena *get_arena;      // the same, but for the 'get' stack
+    int borrow;                        // via procps_pids_borrow, see pids_dupstr
+    struct sort_key *sort_keys;        // for procps_pids_sort's radix path
+    int sort_alloc;                    // number of above allocated (x2)
 };
 
 
@@ -112,8 +140,9 @@ static void freNAME(str) (struct pids_result *R) {
     if (R->result.str && R->result.str != str_none) free(R->result.str);
 }
 
-static void freNAME(strv) (struct pids_result *R) {
-    if (R->result.strv && *R->result.strv) free(*R->result.strv);
+    // for those strings which might be borrowed (see procps_pids_borrow)
+static void freNAME(dup) (struct pids_result *R) {
+    freNAME(str)(R);
 }
 
 
@@ -143,6 +172,27 @@ static const char *pids_sched_to_classstr (
 
 // ___ Results 'Set' Support ||||||||||||||||||||||||||||||||||||||||||||||||||
 
+        /*
+         * Unless borrowed, these strings are each strdup'd then freed on
+         * the next assignment. When borrowed they're instead copied to the
+         * arena that is reset by the next fetch (so there's no free). */
+static inline void pids_dupstr (
+        struct pids_info *I,
+        struct pids_result *R,
+        proc_t *P,
+        const char *str)
+{
+    if (I->borrow)
+        R->result.str = arena_strdup(P->arena, str);
+    else {
+        freNAME(dup)(R);
+        R->result.str = strdup(str);
+    }
+    if (!R->result.str)
+        I->seterr = 1;
+} // end: pids_dupstr
+
+
 #define setNAME(e) set_pids_ ## e
 #define setDECL(e) static void setNAME(e) \
     (struct pids_info *I, struct pids_result *R, proc_t *P)
@@ -150,10 +200,9 @@ static const char *pids_sched_to_classstr (
 /* convert pages to kib */
 #define CVT_set(e,t,x) setDECL(e) { \
     R->result. t = (long)(P-> x) << I -> pgs2k_shift; }
-/* strdup of a static char array */
+/* strdup (or borrow) of a static char array */
 #define DUP_set(e,x) setDECL(e) { \
-    freNAME(str)(R); \
-    if (!(R->result.str = strdup(P-> x))) I->seterr = 1; }
+    pids_dupstr(I, R, P, P-> x); }
 /* regular assignment copy */
 #define REG_set(e,t,x) setDECL(e) { \
     (void)I; R->result. t = P-> x; }
@@ -164,12 +213,17 @@ static const char *pids_sched_to_classstr (
     if (NULL != P-> x) { R->result.str = P-> x; P-> x = NULL; } \
     else { R->result.str = strdup("[ duplicate " STRINGIFY(e) " ]"); \
       if (!R->result.str) I->seterr = 1; } }
-/* take ownership of true vectorized strings if possible, else return
-   some sort of hint that they duplicated this char ** item ... */
+/* take a single string from the proc_t's arena (see pids_stacks_fetch) if
+   possible, else return some sort of hint that they duplicated this item ... */
+#define ARN_set(e,x) setDECL(e) { \
+    if (NULL != P-> x) { R->result.str = P-> x; P-> x = NULL; } \
+    else { R->result.str = arena_strdup(P->arena, "[ duplicate " STRINGIFY(e) " ]"); \
+      if (!R->result.str) I->seterr = 1; } }
+/* take true vectorized strings from the proc_t's arena if possible, else
+   return some sort of hint that they duplicated this char ** item ... */
 #define VEC_set(e,x) setDECL(e) { \
-    freNAME(strv)(R); \
     if (NULL != P-> x) { R->result.strv = P-> x;  P-> x = NULL; } \
-    else { R->result.strv = vectorize_this_str("[ duplicate " STRINGIFY(e) " ]"); \
+    else { R->result.strv = vectorize_this_str(P->arena, "[ duplicate " STRINGIFY(e) " ]"); \
       if (!R->result.strv) I->seterr = 1; } }
 
 
@@ -184,17 +238,22 @@ REG_set(ADDR_STACK_START, ul_int,  start_stack)
 REG_set(AUTOGRP_ID,       s_int,   autogrp_id)
 REG_set(AUTOGRP_NICE,     s_int,   autogrp_nice)
 DUP_set(CAPS_PERMITTED,            capprm)
-STR_set(CGNAME,                    cgname)
-STR_set(CGROUP,                    cgroup)
+ARN_set(CGNAME,                    cgname)
+ARN_set(CGROUP,                    cgroup)
 VEC_set(CGROUP_V,                  cgroup_v)
-STR_set(CMD,                       cmd)
-STR_set(CMDLINE,                   cmdline)
+ARN_set(CMD,                       cmd)
+setDECL(CMD_loan)       { (void)I; R->result.str = P->cmd; } // only for pids_prefilter
+ARN_set(CMDLINE,                   cmdline)
 VEC_set(CMDLINE_V,                 cmdline_v)
+REG_set(CTXSW_INVOL,      ul_int,  nivcsw)
+REG_set(CTXSW_INVOL_DELTA, ul_int, nivcsw_delta)
+REG_set(CTXSW_VOL,        ul_int,  nvcsw)
+REG_set(CTXSW_VOL_DELTA,  ul_int,  nvcsw_delta)
 REG_set(DOCKER_ID,        str,     dockerid)
 REG_set(DOCKER_ID_64,     str,     dockerid_64)
-STR_set(ENVIRON,                   environ)
+ARN_set(ENVIRON,                   environ)
 VEC_set(ENVIRON_V,                 environ_v)
-STR_set(EXE,                       exe)
+ARN_set(EXE,                       exe)
 REG_set(EXIT_SIGNAL,      s_int,   exit_signal)
 REG_set(FLAGS,            ul_int,  flags)
 REG_set(FLT_MAJ,          ul_int,  maj_flt)
@@ -228,12 +287,16 @@ REG_set(ID_TGID,          s_int,   tgid)
 REG_set(ID_TID,           s_int,   tid)
 REG_set(ID_TPGID,         s_int,   tpgid)
 REG_set(IO_READ_BYTES,    ul_int,  read_bytes)
+REG_set(IO_READ_BYTES_DELTA, ul_int, read_bytes_delta)
 REG_set(IO_READ_CHARS,    ul_int,  rchar)
 REG_set(IO_READ_OPS,      ul_int,  syscr)
+REG_set(IO_READ_OPS_DELTA, ul_int, syscr_delta)
 REG_set(IO_WRITE_BYTES,   ul_int,  write_bytes)
+REG_set(IO_WRITE_BYTES_DELTA, ul_int, write_bytes_delta)
 REG_set(IO_WRITE_CBYTES,  ul_int,  cancelled_write_bytes)
 REG_set(IO_WRITE_CHARS,   ul_int,  wchar)
 REG_set(IO_WRITE_OPS,     ul_int,  syscw)
+REG_set(IO_WRITE_OPS_DELTA, ul_int, syscw_delta)
 REG_set(LXCNAME,          str,     lxcname)
 CVT_set(MEM_CODE,         ul_int,  trs)
 REG_set(MEM_CODE_PGS,     ul_int,  trs)
@@ -315,13 +378,13 @@ REG_set(TICS_USER,        ull_int, utime)
 setDECL(TICS_USER_C)    { (void)I; R->result.ull_int = P->utime + P->cutime; }
 setDECL(TIME_ALL)       { R->result.real = ((double)P->utime + P->stime) / I->hertz; }
 setDECL(TIME_ALL_C)     { R->result.real = ((double)P->utime + P->stime + P->cutime + P->cstime) / I->hertz; }
-setDECL(TIME_ELAPSED)   { double t = (double)I->boot_tics - P->start_time; if (t > 0) R->result.real = t / I->hertz; }
+setDECL(TIME_ELAPSED)   { double t = (double)I->boot_tics - P->start_time; R->result.real = 0; if (t > 0) R->result.real = t / I->hertz; }
 setDECL(TIME_START)     { R->result.real = (double)P->start_time / I->hertz; }
 REG_set(TTY,              s_int,   tty)
-setDECL(TTY_NAME)       { char buf[64]; freNAME(str)(R); dev_to_tty(buf, sizeof(buf), P->tty, P->tid, ABBREV_DEV); if (!(R->result.str = strdup(buf))) I->seterr = 1; }
-setDECL(TTY_NUMBER)     { char buf[64]; freNAME(str)(R); dev_to_tty(buf, sizeof(buf), P->tty, P->tid, ABBREV_DEV|ABBREV_TTY|ABBREV_PTS); if (!(R->result.str = strdup(buf))) I->seterr = 1; }
-setDECL(UTILIZATION)    { double t = (double)I->boot_tics - P->start_time; if (t > 0) R->result.real = ((P->utime + P->stime) * 100.0f) / t; }
-setDECL(UTILIZATION_C)  { double t = (double)I->boot_tics - P->start_time; if (t > 0) R->result.real = ((P->utime + P->stime + P->cutime + P->cstime) * 100.0f) / t; }
+setDECL(TTY_NAME)       { char buf[64]; dev_to_tty(buf, sizeof(buf), P->tty, P->tid, ABBREV_DEV); pids_dupstr(I, R, P, buf); }
+setDECL(TTY_NUMBER)     { char buf[64]; dev_to_tty(buf, sizeof(buf), P->tty, P->tid, ABBREV_DEV|ABBREV_TTY|ABBREV_PTS); pids_dupstr(I, R, P, buf); }
+setDECL(UTILIZATION)    { double t = (double)I->boot_tics - P->start_time; R->result.real = 0; if (t > 0) R->result.real = ((P->utime + P->stime) * 100.0f) / t; }
+setDECL(UTILIZATION_C)  { double t = (double)I->boot_tics - P->start_time; R->result.real = 0; if (t > 0) R->result.real = ((P->utime + P->stime + P->cutime + P->cstime) * 100.0f) / t; }
 REG_set(VM_DATA,          ul_int,  vm_data)
 REG_set(VM_EXE,           ul_int,  vm_exe)
 REG_set(VM_LIB,           ul_int,  vm_lib)
@@ -335,13 +398,14 @@ REG_set(VM_STACK,         ul_int,  vm_stack)
 REG_set(VM_SWAP,          ul_int,  vm_swap)
 setDECL(VM_USED)        { (void)I; R->result.ul_int = P->vm_swap + P->vm_rss; }
 REG_set(VSIZE_BYTES,      ul_int,  vsize)
-setDECL(WCHAN_NAME)     { freNAME(str)(R); if (!(R->result.str = strdup(lookup_wchan(P->tid)))) I->seterr = 1; }
+setDECL(WCHAN_NAME)     { pids_dupstr(I, R, P, lookup_wchan(P->tid)); }
 
 #undef setDECL
 #undef CVT_set
 #undef DUP_set
 #undef REG_set
 #undef STR_set
+#undef ARN_set
 #undef VEC_set
 
 
@@ -352,6 +416,13 @@ struct sort_parms {
     enum pids_sort_order order;
 };
 
+struct sort_key {
+    unsigned long long key;            // the result, as an ordered unsigned
+    struct pids_stack *stack;
+};
+
+#define SORT_RADIX_MIN  256            // below this, mergesort will be faster
+
 #define srtNAME(t) sort_pids_ ## t
 #define srtDECL(t) static int srtNAME(t) \
     (const struct pids_stack **A, const struct pids_stack **B, struct sort_parms *P)
@@ -480,18 +551,22 @@ static struct {
     { RS(ADDR_STACK_START),  f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(AUTOGRP_ID),        z_autogrp,  NULL,      QS(s_int),     0,        TS(s_int)   },
     { RS(AUTOGRP_NICE),      z_autogrp,  NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(CAPS_PERMITTED),    f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CGNAME),            x_cgroup,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CGROUP),            x_cgroup,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CGROUP_V),          v_cgroup,   FF(strv),  QS(strv),      0,        TS(strv)    },
-    { RS(CMD),               f_either,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CMDLINE),           x_cmdline,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(CMDLINE_V),         v_arg,      FF(strv),  QS(strv),      0,        TS(strv)    },
+    { RS(CAPS_PERMITTED),    f_status,   FF(dup),   QS(str),       0,        TS(str)     },
+    { RS(CGNAME),            x_cgroup,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ arena string
+    { RS(CGROUP),            x_cgroup,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ arena string
+    { RS(CGROUP_V),          v_cgroup,   NULL,      QS(strv),      0,        TS(strv)    }, // freefunc NULL w/ arena string
+    { RS(CMD),               f_either,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ arena string
+    { RS(CMDLINE),           x_cmdline,  NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ arena string
+    { RS(CMDLINE_V),         v_arg,      NULL,      QS(strv),      0,        TS(strv)    }, // freefunc NULL w/ arena string
+    { RS(CTXSW_INVOL),       f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(CTXSW_INVOL_DELTA), f_status,   NULL,      QS(ul_int),    +1,       TS(ul_int)  },
+    { RS(CTXSW_VOL),         f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(CTXSW_VOL_DELTA),   f_status,   NULL,      QS(ul_int),    +1,       TS(ul_int)  },
     { RS(DOCKER_ID),         z_docker,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
     { RS(DOCKER_ID_64),      z_docker,   NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
-    { RS(ENVIRON),           x_environ,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(ENVIRON_V),         v_env,      FF(strv),  QS(strv),      0,        TS(strv)    },
-    { RS(EXE),               f_exe,      FF(str),   QS(str),       0,        TS(str)     },
+    { RS(ENVIRON),           x_environ,  NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ arena string
+    { RS(ENVIRON_V),         v_env,      NULL,      QS(strv),      0,        TS(strv)    }, // freefunc NULL w/ arena string
+    { RS(EXE),               f_exe,      NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ arena string
     { RS(EXIT_SIGNAL),       f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
     { RS(FLAGS),             f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(FLT_MAJ),           f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
@@ -525,12 +600,16 @@ static struct {
     { RS(ID_TID),            0,          NULL,      QS(s_int),     0,        TS(s_int)   }, // oldflags: free w/ simple_nexttid
     { RS(ID_TPGID),          f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
     { RS(IO_READ_BYTES),     f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_READ_BYTES_DELTA), f_io,     NULL,      QS(ul_int),    +1,       TS(ul_int)  },
     { RS(IO_READ_CHARS),     f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(IO_READ_OPS),       f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_READ_OPS_DELTA), f_io,       NULL,      QS(ul_int),    +1,       TS(ul_int)  },
     { RS(IO_WRITE_BYTES),    f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_WRITE_BYTES_DELTA), f_io,    NULL,      QS(ul_int),    +1,       TS(ul_int)  },
     { RS(IO_WRITE_CBYTES),   f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(IO_WRITE_CHARS),    f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(IO_WRITE_OPS),      f_io,       NULL,      QS(ul_int),    0,        TS(ul_int)  },
+    { RS(IO_WRITE_OPS_DELTA), f_io,      NULL,      QS(ul_int),    +1,       TS(ul_int)  },
     { RS(LXCNAME),           f_lxc,      NULL,      QS(str),       0,        TS(str)     }, // freefunc NULL w/ cached string
     { RS(MEM_CODE),          f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(MEM_CODE_PGS),      f_statm,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
@@ -570,11 +649,11 @@ static struct {
     { RS(SD_SLICE),          f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
     { RS(SD_UNIT),           f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
     { RS(SD_UUNIT),          f_systemd,  FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGBLOCKED),        f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGCATCH),          f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGIGNORE),         f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGNALS),           f_status,   FF(str),   QS(str),       0,        TS(str)     },
-    { RS(SIGPENDING),        f_status,   FF(str),   QS(str),       0,        TS(str)     },
+    { RS(SIGBLOCKED),        f_status,   FF(dup),   QS(str),       0,        TS(str)     },
+    { RS(SIGCATCH),          f_status,   FF(dup),   QS(str),       0,        TS(str)     },
+    { RS(SIGIGNORE),         f_status,   FF(dup),   QS(str),       0,        TS(str)     },
+    { RS(SIGNALS),           f_status,   FF(dup),   QS(str),       0,        TS(str)     },
+    { RS(SIGPENDING),        f_status,   FF(dup),   QS(str),       0,        TS(str)     },
     { RS(SMAP_ANONYMOUS),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(SMAP_HUGE_ANON),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(SMAP_HUGE_FILE),    f_smaps,    NULL,      QS(ul_int),    0,        TS(ul_int)  },
@@ -615,8 +694,8 @@ static struct {
     { RS(TIME_ELAPSED),      f_stat,     NULL,      QS(real),      0,        TS(real)    },
     { RS(TIME_START),        f_stat,     NULL,      QS(real),      0,        TS(real)    },
     { RS(TTY),               f_stat,     NULL,      QS(s_int),     0,        TS(s_int)   },
-    { RS(TTY_NAME),          f_stat,     FF(str),   QS(strvers),   0,        TS(str)     },
-    { RS(TTY_NUMBER),        f_stat,     FF(str),   QS(strvers),   0,        TS(str)     },
+    { RS(TTY_NAME),          f_stat,     FF(dup),   QS(strvers),   0,        TS(str)     },
+    { RS(TTY_NUMBER),        f_stat,     FF(dup),   QS(strvers),   0,        TS(str)     },
     { RS(UTILIZATION),       f_stat,     NULL,      QS(real),      0,        TS(real)    },
     { RS(UTILIZATION_C),     f_stat,     NULL,      QS(real),      0,        TS(real)    },
     { RS(VM_DATA),           f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
@@ -632,7 +711,7 @@ static struct {
     { RS(VM_SWAP),           f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(VM_USED),           f_status,   NULL,      QS(ul_int),    0,        TS(ul_int)  },
     { RS(VSIZE_BYTES),       f_stat,     NULL,      QS(ul_int),    0,        TS(ul_int)  },
-    { RS(WCHAN_NAME),        0,          FF(str),   QS(str),       0,        TS(str)     }, // oldflags: tid already free
+    { RS(WCHAN_NAME),        0,          FF(dup),   QS(str),       0,        TS(str)     }, // oldflags: tid already free
 };
 
     /* please note,
@@ -677,8 +756,8 @@ enum pids_item PIDS_logical_end = MAXTABLE(Item_table);
 // ___ History Support Private Functions ||||||||||||||||||||||||||||||||||||||
 //   ( stolen from top when he wasn't looking ) -------------------------------
 
-#define HHASH_SIZE  4096
-#define _HASH_PID_(K) (K & (HHASH_SIZE - 1))
+#define HHASH_BITS  12                 // initial slots, as a power of 2
+#define HHASH_LOAD(n,bits)  ((n) * 2 > (1u << (bits)))  // at most half full
 
 #define Hr(x)  info->hist->x           // 'hist ref', minimize stolen impact
 
@@ -687,48 +766,83 @@ typedef unsigned long long TIC_t;
 typedef struct HST_t {
     TIC_t tics;                        // last frame's tics count
     unsigned long maj, min;            // last frame's maj/min_flt counts
-    int pid;                           // record 'key'
-    int lnk;                           // next on hash chain
+    unsigned long rbytes, wbytes;      // last frame's read/write_bytes counts
+    unsigned long syscr, syscw;        // last frame's syscr/syscw counts
+    unsigned long nvcsw, nivcsw;       // last frame's (in)voluntary switches
+    unsigned long long start;          // start_time, with pid the record 'key'
+    int pid;                           //  (a reused pid won't share a start)
 } HST_t;
 
 
+        /*
+         * The hash tables are open addressed (linear probing) and hold an
+         * index into the corresponding HST_t array, or -1 if unused. Each
+         * grows by doubling whenever the tasks for a frame would leave it
+         * more than half full, so that chains never build up (as they did
+         * with the former fixed size 4096 table under 'top -H' on a busy
+         * host). Likewise, one far too large for the last frame shrinks. */
 struct history_info {
     int    num_tasks;                  // used as index (tasks tallied)
     int    HHist_siz;                  // max number of HST_t structs
     HST_t *PHist_sav;                  // alternating 'old/new' HST_t anchors
     HST_t *PHist_new;
-    int    HHash_one [HHASH_SIZE];     // the actual hash tables
-    int    HHash_two [HHASH_SIZE];     // (accessed via PHash_sav/PHash_new)
-    int    HHash_nul [HHASH_SIZE];     // an 'empty' hash table image
     int   *PHash_sav;                  // alternating 'old/new' hash tables
-    int   *PHash_new;                  // (aka. the 'one/two' actual tables)
+    int   *PHash_new;
+    unsigned HHash_sav_bits;           // thus 1 << bits slots in each of
+    unsigned HHash_new_bits;           //  the above tables
+    unsigned HHash_grows;              // resizings, for procps_pids_hist_stats
 };
 
 
-static void pids_config_history (
-        struct pids_info *info)
+    // multiplicative (fibonacci) hashing keeps neighboring pids apart
+static inline unsigned pids_histhome (
+        int pid,
+        unsigned bits)
 {
-    int i;
+    return ((unsigned)pid * 2654435761u) >> (32 - bits);
+} // end: pids_histhome
+
+
+static int pids_histalloc (
+        int **table,
+        unsigned bits)
+{
+    int *new;
 
-    for (i = 0; i < HHASH_SIZE; i++)   // make the 'empty' table image
-        Hr(HHash_nul[i]) = -1;
-    memcpy(Hr(HHash_one), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
-    memcpy(Hr(HHash_two), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
-    Hr(PHash_sav) = Hr(HHash_one);     // alternating 'old/new' hash tables
-    Hr(PHash_new) = Hr(HHash_two);
+    if (!(new = malloc(sizeof(int) << bits)))
+        return 0;
+    memset(new, -1, sizeof(int) << bits);
+    free(*table);
+    *table = new;
+    return 1;
+} // end: pids_histalloc
+
+
+static int pids_config_history (
+        struct pids_info *info)
+{
+    if (!pids_histalloc(&Hr(PHash_sav), HHASH_BITS)
+    || (!pids_histalloc(&Hr(PHash_new), HHASH_BITS)))
+        return 0;
+    Hr(HHash_sav_bits) = Hr(HHash_new_bits) = HHASH_BITS;
+    return 1;
 } // end: pids_config_history
 
 
 static inline HST_t *pids_histget (
         struct pids_info *info,
-        int pid)
+        int pid,
+        unsigned long long start)
 {
-    int V = Hr(PHash_sav[_HASH_PID_(pid)]);
+    unsigned msk = (1u << Hr(HHash_sav_bits)) - 1;
+    unsigned i = pids_histhome(pid, Hr(HHash_sav_bits));
+    int V;
 
-    while (-1 < V) {
-        if (Hr(PHist_sav[V].pid) == pid)
+    while (-1 < (V = Hr(PHash_sav[i]))) {
+        if (Hr(PHist_sav[V].pid) == pid
+        && (Hr(PHist_sav[V].start) == start))
             return &Hr(PHist_sav[V]);
-        V = Hr(PHist_sav[V].lnk);
+        i = (i + 1) & msk;
     }
     return NULL;
 } // end: pids_histget
@@ -738,13 +852,28 @@ static inline void pids_histput (
         struct pids_info *info,
         unsigned this)
 {
-    int V = _HASH_PID_(Hr(PHist_new[this].pid));
+    unsigned msk = (1u << Hr(HHash_new_bits)) - 1;
+    unsigned i = pids_histhome(Hr(PHist_new[this].pid), Hr(HHash_new_bits));
 
-    Hr(PHist_new[this].lnk) = Hr(PHash_new[V]);
-    Hr(PHash_new[V] = this);
+    while (-1 < Hr(PHash_new[i]))
+        i = (i + 1) & msk;
+    Hr(PHash_new[i]) = this;
 } // end: pids_histput
 
-#undef _HASH_PID_
+
+static int pids_histgrow (
+        struct pids_info *info)
+{
+    int i;
+
+    if (!pids_histalloc(&Hr(PHash_new), Hr(HHash_new_bits) + 1))
+        return 0;
+    Hr(HHash_new_bits)++;
+    Hr(HHash_grows)++;
+    for (i = 0; i < info->hist->num_tasks; i++)
+        pids_histput(info, i);
+    return 1;
+} // end: pids_histgrow
 
 
 static inline int pids_make_hist (
@@ -762,17 +891,33 @@ static inline int pids_make_hist (
         if (!Hr(PHist_sav) || !Hr(PHist_new))
             return 0;
     }
+    if (HHASH_LOAD(slot + 1, Hr(HHash_new_bits))
+    && !pids_histgrow(info))
+        return 0;
     Hr(PHist_new[slot].pid)  = p->tid;
+    Hr(PHist_new[slot].start) = p->start_time;
     Hr(PHist_new[slot].maj)  = p->maj_flt;
     Hr(PHist_new[slot].min)  = p->min_flt;
     Hr(PHist_new[slot].tics) = tics = (p->utime + p->stime);
+    Hr(PHist_new[slot].rbytes) = p->read_bytes;
+    Hr(PHist_new[slot].wbytes) = p->write_bytes;
+    Hr(PHist_new[slot].syscr) = p->syscr;
+    Hr(PHist_new[slot].syscw) = p->syscw;
+    Hr(PHist_new[slot].nvcsw) = p->nvcsw;
+    Hr(PHist_new[slot].nivcsw) = p->nivcsw;
 
     pids_histput(info, slot);
 
-    if ((h = pids_histget(info, p->tid))) {
+    if ((h = pids_histget(info, p->tid, p->start_time))) {
         tics -= h->tics;
         p->maj_delta = p->maj_flt - h->maj;
         p->min_delta = p->min_flt - h->min;
+        p->read_bytes_delta = p->read_bytes - h->rbytes;
+        p->write_bytes_delta = p->write_bytes - h->wbytes;
+        p->syscr_delta = p->syscr - h->syscr;
+        p->syscw_delta = p->syscw - h->syscw;
+        p->nvcsw_delta = p->nvcsw - h->nvcsw;
+        p->nivcsw_delta = p->nivcsw - h->nivcsw;
     }
     /* here we're saving elapsed tics, which will include any
        tasks not previously seen via that pids_histget() guy! */
@@ -786,6 +931,7 @@ static inline int pids_make_hist (
 static inline void pids_toggle_history (
         struct pids_info *info)
 {
+    unsigned bits;
     void *v;
 
     v = Hr(PHist_sav);
@@ -795,99 +941,78 @@ static inline void pids_toggle_history (
     v = Hr(PHash_sav);
     Hr(PHash_sav) = Hr(PHash_new);
     Hr(PHash_new) = v;
-    memcpy(Hr(PHash_new), Hr(HHash_nul), sizeof(Hr(HHash_nul)));
+    bits = Hr(HHash_sav_bits);
+    Hr(HHash_sav_bits) = Hr(HHash_new_bits);
+    Hr(HHash_new_bits) = bits;
+
+    // a table far larger than the last frame needed is just costly to clear
+    for (bits = HHASH_BITS; HHASH_LOAD(info->hist->num_tasks, bits); bits++)
+        ;
+    if (Hr(HHash_new_bits) > bits + 2
+    && (pids_histalloc(&Hr(PHash_new), bits))) {
+        Hr(HHash_new_bits) = bits;
+        Hr(HHash_grows)++;
+    } else
+        memset(Hr(PHash_new), -1, sizeof(int) << Hr(HHash_new_bits));
 
     info->hist->num_tasks = 0;
 } // end: pids_toggle_history
 
 
+static void pids_hist_tally (
+        struct pids_info *info,
+        struct pids_hist_stats *stats)
+{
+    unsigned i, msk = (1u << Hr(HHash_new_bits)) - 1, probes;
+    int V;
+
+    memset(stats, 0, sizeof(struct pids_hist_stats));
+    stats->tasks = info->hist->num_tasks;
+    stats->slots = msk + 1;
+    stats->resizes = Hr(HHash_grows);
+    stats->bytes = (sizeof(HST_t) * Hr(HHist_siz) * 2)
+        + (sizeof(int) << Hr(HHash_sav_bits)) + (sizeof(int) << Hr(HHash_new_bits));
+
+    for (i = 0; i <= msk; i++) {
+        if (-1 < (V = Hr(PHash_new[i]))) {
+            probes = ((i - pids_histhome(Hr(PHist_new[V].pid), Hr(HHash_new_bits))) & msk) + 1;
+            stats->probes_total += probes;
+            if (stats->probes_max < probes)
+                stats->probes_max = probes;
+        }
+    }
+} // end: pids_hist_tally
+
+
 #ifdef UNREF_RPTHASH
 static void pids_unref_rpthash (
         struct pids_info *info)
 {
-    int i, j, pop, total_occupied, maxdepth, maxdepth_sav, numdepth
-        , cross_foot, sz = HHASH_SIZE * (int)sizeof(int)
-        , hsz = (int)sizeof(HST_t) * Hr(HHist_siz);
-    int depths[HHASH_SIZE];
-
-    for (i = 0, total_occupied = 0, maxdepth = 0; i < HHASH_SIZE; i++) {
-        int V = Hr(PHash_new[i]);
-        j = 0;
-        if (-1 < V) {
-            ++total_occupied;
-            while (-1 < V) {
-                V = Hr(PHist_new[V].lnk);
-                if (-1 < V) j++;
-            }
-        }
-        depths[i] = j;
-        if (maxdepth < j) maxdepth = j;
-    }
-    maxdepth_sav = maxdepth;
+    struct pids_hist_stats s;
 
+    pids_hist_tally(info, &s);
     fprintf(stderr,
         "\n    History Memory Costs:"
-        "\n\tHST_t size = %d, total allocated = %d,"
-        "\n\tthus PHist_new & PHist_sav consumed %dk (%d) total bytes."
-        "\n"
-        "\n\tTwo hash tables provide for %d entries each + 1 extra 'empty' image,"
-        "\n\tthus %dk (%d) bytes per table for %dk (%d) total bytes."
-        "\n"
-        "\n\tGrand total = %dk (%d) bytes."
+        "\n\tHST_t size = %d, total allocated = %d (x2),"
+        "\n\tplus two hash tables, thus %luk (%lu) total bytes."
         "\n"
         "\n    Hash Results Report:"
-        "\n\tTotal hashed = %d"
-        "\n\tLevel-0 hash entries = %d (%d%% occupied)"
-        "\n\tMax Depth = %d"
+        "\n\tTotal hashed = %u, in %u slots (%u%% occupied)"
+        "\n\tResized %u times"
+        "\n\tProbes: average = %.2f, max = %u"
         "\n\n"
         , (int)sizeof(HST_t),  Hr(HHist_siz)
-        , hsz / 1024, hsz
-        , HHASH_SIZE
-        , sz / 1024, sz, (sz * 3) / 1024, sz * 3
-        , (hsz + (sz * 3)) / 1024, hsz + (sz * 3)
-        , info->hist->num_tasks
-        , total_occupied, (total_occupied * 100) / HHASH_SIZE
-        , maxdepth);
-
-    if (total_occupied) {
-        for (pop = total_occupied, cross_foot = 0; maxdepth; maxdepth--) {
-            for (i = 0, numdepth = 0; i < HHASH_SIZE; i++)
-                if (depths[i] == maxdepth) ++numdepth;
-            if (numdepth) fprintf(stderr,
-                "\t %5d (%3d%%) hash table entries at depth %d\n"
-                , numdepth, (numdepth * 100) / total_occupied, maxdepth);
-            pop -= numdepth;
-            cross_foot += numdepth;
-            if (0 == pop && cross_foot == total_occupied) break;
-        }
-        if (pop) {
-            fprintf(stderr, "\t %5d (%3d%%) unchained entries (at depth 0)\n"
-                , pop, (pop * 100) / total_occupied);
-            cross_foot += pop;
-        }
-        fprintf(stderr,
-            "\t -----\n"
-            "\t %5d total entries occupied\n", cross_foot);
-
-        if (maxdepth_sav > 1) {
-            fprintf(stderr, "\n    PIDs at max depth: ");
-            for (i = 0; i < HHASH_SIZE; i++)
-                if (depths[i] == maxdepth_sav) {
-                    j = Hr(PHash_new[i]);
-                    fprintf(stderr, "\n\tpos %4d:  %05d", i, Hr(PHist_new[j].pid));
-                    while (-1 < j) {
-                        j = Hr(PHist_new[j].lnk);
-                        if (-1 < j) fprintf(stderr, ", %05d", Hr(PHist_new[j].pid));
-                    }
-                }
-            fprintf(stderr, "\n");
-        }
-    }
+        , s.bytes / 1024, s.bytes
+        , s.tasks, s.slots, (s.tasks * 100) / s.slots
+        , s.resizes
+        , s.tasks ? (double)s.probes_total / s.tasks : 0.0
+        , s.probes_max);
 } // end: pids_unref_rpthash
 #endif // UNREF_RPTHASH
 
 #undef Hr
-#undef HHASH_SIZE
+#undef HHASH_BITS
+#undef HHASH_LOAD
 
 
 // ___ Unique/Specialized Private Function(s) |||||||||||||||||||||||||||||||||
@@ -938,13 +1063,15 @@ static inline int pids_assign_results (
 
 
 static inline void pids_cleanup_stack (
+        struct pids_info *info,
         struct pids_result *this)
 {
     for (;;) {
         enum pids_item item = this->item;
         if (item >= PIDS_logical_end)
             break;
-        if (Item_table[item].freefunc)
+        if (Item_table[item].freefunc
+        && !(info->borrow && Item_table[item].freefunc == (FRE_t)free_pids_dup))
             Item_table[item].freefunc(this);
         this->result.ull_int = 0;
         ++this;
@@ -960,12 +1087,96 @@ static inline void pids_cleanup_stacks_all (
 
     while (ext) {
         for (i = 0; ext->stacks[i]; i++)
-            pids_cleanup_stack(ext->stacks[i]->head);
+            pids_cleanup_stack(info, ext->stacks[i]->head);
         ext = ext->next;
     };
 } // end: pids_cleanup_stacks_all
 
 
+static int pids_column_width (
+        enum pids_item item)
+{
+    static const struct {
+        const char *type;
+        int width;
+    } widths[] = {
+        { "s_ch",    sizeof(signed char)        },
+        { "s_int",   sizeof(signed int)         },
+        { "u_int",   sizeof(unsigned int)       },
+        { "ul_int",  sizeof(unsigned long)      },
+        { "ull_int", sizeof(unsigned long long) },
+        { "str",     sizeof(char *)             },
+        { "strv",    sizeof(char **)            },
+        { "real",    sizeof(double)             }
+    };
+    int i;
+
+    for (i = 0; i < (int)MAXTABLE(widths); i++)
+        if (!strcmp(Item_table[item].type2str, widths[i].type))
+            return widths[i].width;
+    // noop & extra belong to the user, so we'll copy all their bits
+    return sizeof(unsigned long long);
+} // end: pids_column_width
+
+
+static int pids_columns_fill (
+        struct pids_info *info,
+        struct pids_fetch *fetched)
+{
+ #define colALIGN(n)  (((n) + 7) & ~(size_t)7)
+ #define colCOPY(w)  for (r = 0; r < numrows; r++) \
+    memcpy(dst + r * (w), &fetched->stacks[r]->head[c].result, (w))
+    struct column_support *col = &info->columns;
+    int numcols = info->maxitems - 1;
+    int numrows = fetched->counts->total;
+    size_t need;
+    char *dst;
+    int c, r, w;
+
+    if (numcols > col->n_alloc_cols) {
+        struct pids_column *cols;
+        if (!(cols = realloc(col->results.cols, sizeof(struct pids_column) * numcols)))
+            return 0;
+        col->results.cols = cols;
+        col->n_alloc_cols = numcols;
+    }
+    for (need = 0, c = 0; c < numcols; c++)
+        need += colALIGN((size_t)numrows * pids_column_width(info->items[c]));
+    if (need > col->n_alloc_values) {
+        // a little extra, lest the very next reap find another task or two
+        need += need / 8;
+        free(col->values);
+        if (!(col->values = malloc(need))) {
+            col->n_alloc_values = 0;
+            return 0;
+        }
+        col->n_alloc_values = need;
+    }
+
+    /* one column at a time, so each store is sequential ( the loads hop
+       among stacks, but only once -- every later pass will be linear ) */
+    dst = col->values;
+    for (c = 0; c < numcols; c++) {
+        col->results.cols[c].item = info->items[c];
+        col->results.cols[c].result.s_ch = (signed char *)dst;
+        switch ((w = pids_column_width(info->items[c]))) {
+            case 1:  colCOPY(1); break;
+            case 4:  colCOPY(4); break;
+            case 8:  colCOPY(8); break;
+            default: colCOPY(w); break;
+        }
+        dst += colALIGN((size_t)numrows * w);
+    }
+    col->results.counts = fetched->counts;
+    col->results.stacks = fetched->stacks;
+    col->results.numrows = numrows;
+    col->results.numcols = numcols;
+    return 1;
+ #undef colALIGN
+ #undef colCOPY
+} // end: pids_columns_fill
+
+
 #if 0   // not currently needed after 'fatal_proc_unmounted' was refactored
         /*
          * This routine exists in case we ever want to offer something like
@@ -995,6 +1206,29 @@ static struct stacks_extent *pids_extent_cut (
 #endif  // ----------------------------------------------------------------
 
 
+        /*
+         * An item is 'cheap' if it can be valued from the 'stat' file or the
+         * directory fstat() alone, which readproc.c will always have done,
+         * plus it requires neither history nor any further name lookups. */
+static inline int pids_item_is_cheap (
+        enum pids_item e)
+{
+    if (Item_table[e].oldflags & ~(f_stat | f_either))
+        return 0;
+    if (Item_table[e].needhist)
+        return 0;
+    switch (e) {
+        case PIDS_TTY_NAME:
+        case PIDS_TTY_NUMBER:
+        case PIDS_WCHAN_NAME:
+            return 0;
+        default:
+            break;
+    }
+    return 1;
+} // end: pids_item_is_cheap
+
+
 static inline struct pids_result *pids_itemize_stack (
         struct pids_result *p,
         int depth,
@@ -1122,10 +1356,24 @@ static int pids_prep_func_array (
     for (i = 0; i < info->maxitems -1; i++)
         info->func_array[i] = Item_table[info->items[i]].setsfunc;
     info->func_array[i] = NULL;
+
+    if (!(info->filter_array = realloc(info->filter_array, sizeof(SET_t) * info->maxitems)))
+        return 0;
+    for (i = 0; i < info->maxitems -1; i++) {
+        enum pids_item e = info->items[i];
+        if (e == PIDS_CMD)
+            info->filter_array[i] = (SET_t)set_pids_CMD_loan;
+        else if (pids_item_is_cheap(e))
+            info->filter_array[i] = Item_table[e].setsfunc;
+        else
+            info->filter_array[i] = Item_table[PIDS_noop].setsfunc;
+    }
+    info->filter_array[i] = NULL;
     return 1;
 } // end: pids_prep_func_array
 
 
+
 static inline int pids_proc_tally (
         struct pids_info *info,
         struct pids_counts *counts,
@@ -1164,6 +1412,230 @@ static inline int pids_proc_tally (
 } // end: pids_proc_tally
 
 
+        /*
+         * A stable LSD radix sort for those numeric items, with each result
+         * first extracted (as a key to be compared without a sign) alongside
+         * its stack, so no stack is touched again until the final store. The
+         * bytes found identical in every key (like those high order zeros)
+         * are skipped entirely.
+         *
+         * Returns 1 when sorted, else 0 (to be handled by mergesort). */
+static int pids_sort_radix (
+        struct pids_info *info,
+        struct pids_stack *stacks[],
+        int numstacked,
+        QSR_t sortfunc,
+        struct sort_parms *parms)
+{
+ #define keyLOAD(t,x) for (i = 0; i < numstacked; i++) { \
+    v = stacks[i]->head[parms->offset].result. t; \
+    src[i].key = (x) ^ flip; src[i].stack = stacks[i]; }
+    unsigned counts[sizeof(unsigned long long)][256];
+    struct sort_key *src, *dst, *tmp;
+    unsigned long long flip, sign = 1ull << 63;
+    unsigned long long v;
+    double real;
+    unsigned pos, n;
+    int i, d, b;
+
+    if (numstacked < SORT_RADIX_MIN)
+        return 0;
+    if (sortfunc != (QSR_t)sort_pids_s_ch && sortfunc != (QSR_t)sort_pids_s_int
+    && sortfunc != (QSR_t)sort_pids_u_int && sortfunc != (QSR_t)sort_pids_ul_int
+    && sortfunc != (QSR_t)sort_pids_ull_int && sortfunc != (QSR_t)sort_pids_real)
+        return 0;
+    if (numstacked > info->sort_alloc) {
+        free(info->sort_keys);
+        info->sort_alloc = 0;
+        if (!(info->sort_keys = malloc(sizeof(struct sort_key) * 2 * numstacked)))
+            return 0;
+        info->sort_alloc = numstacked;
+    }
+    src = info->sort_keys;
+    dst = src + numstacked;
+    // descending is just ascending with every key inverted (and still stable)
+    flip = parms->order > 0 ? 0 : ~0ull;
+
+    if (sortfunc == (QSR_t)sort_pids_s_ch) {
+        keyLOAD(s_ch, (unsigned long long)(signed long long)(signed char)v ^ sign)
+    } else if (sortfunc == (QSR_t)sort_pids_s_int) {
+        keyLOAD(s_int, (unsigned long long)(signed long long)(signed int)v ^ sign)
+    } else if (sortfunc == (QSR_t)sort_pids_u_int) {
+        keyLOAD(u_int, v)
+    } else if (sortfunc == (QSR_t)sort_pids_ul_int) {
+        keyLOAD(ul_int, v)
+    } else if (sortfunc == (QSR_t)sort_pids_ull_int) {
+        keyLOAD(ull_int, v)
+    } else {
+        for (i = 0; i < numstacked; i++) {
+            // adding zero makes a -0.0 into 0.0, which is then equal to it
+            real = stacks[i]->head[parms->offset].result.real + 0.0;
+            if (real != real)
+                return 0;    // a NaN, which the comparator views as equal to all
+            memcpy(&v, &real, sizeof(v));
+            v = (v & sign) ? ~v : v | sign;
+            src[i].key = v ^ flip;
+            src[i].stack = stacks[i];
+        }
+    }
+
+    memset(counts, 0, sizeof(counts));
+    for (i = 0; i < numstacked; i++)
+        for (d = 0, v = src[i].key; d < (int)sizeof(v); d++, v >>= 8)
+            ++counts[d][v & 0xff];
+
+    for (d = 0; d < (int)sizeof(v); d++) {
+        if (counts[d][(src[0].key >> (d * 8)) & 0xff] == (unsigned)numstacked)
+            continue;
+        for (pos = 0, b = 0; b < 256; b++) {
+            n = counts[d][b];
+            counts[d][b] = pos;
+            pos += n;
+        }
+        for (i = 0; i < numstacked; i++)
+            dst[counts[d][(src[i].key >> (d * 8)) & 0xff]++] = src[i];
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    for (i = 0; i < numstacked; i++)
+        stacks[i] = src[i].stack;
+    return 1;
+ #undef keyLOAD
+} // end: pids_sort_radix
+
+
+        /*
+         * Find where the sortitem lives in those (homogeneous) stacks.
+         *
+         * Returns its offset, else -1 if it's not to be found. */
+static int pids_sort_offset (
+        struct pids_info *info,
+        struct pids_stack *stack,
+        enum pids_item sortitem)
+{
+    struct pids_result *p = stack->head;
+    int offset = 0;
+
+    for (;;) {
+        if (p->item == sortitem)
+            return offset;
+        ++offset;
+        if (offset >= info->maxitems)
+            return -1;
+        if (p->item >= PIDS_logical_end)
+            return -1;
+        ++p;
+    }
+} // end: pids_sort_offset
+
+
+        /*
+         * The worse of two stacks (the one sorting last) is that with the
+         * greater result, or when equal, the greater subscript (stability).
+         */
+static inline int pids_topk_worse (
+        struct pids_stack *stacks[],
+        int a,
+        int b,
+        QSR_t sortfunc,
+        struct sort_parms *parms)
+{
+    int rc = sortfunc(&stacks[a], &stacks[b], parms);
+
+    return rc ? rc > 0 : a > b;
+} // end: pids_topk_worse
+
+
+static inline void pids_topk_siftdown (
+        struct pids_stack *stacks[],
+        int *heap,
+        int num,
+        int i,
+        QSR_t sortfunc,
+        struct sort_parms *parms)
+{
+    int kid, tmp;
+
+    // a max heap, keeping the worst of those k best at heap[0]
+    while ((kid = 2 * i + 1) < num) {
+        if (kid + 1 < num && pids_topk_worse(stacks, heap[kid + 1], heap[kid], sortfunc, parms))
+            ++kid;
+        if (!pids_topk_worse(stacks, heap[kid], heap[i], sortfunc, parms))
+            break;
+        tmp = heap[i];
+        heap[i] = heap[kid];
+        heap[kid] = tmp;
+        i = kid;
+    }
+} // end: pids_topk_siftdown
+
+
+static int pids_topk_cmpint (
+        const void *a,
+        const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+} // end: pids_topk_cmpint
+
+
+        /*
+         * Select the best k (by way of a bounded heap) then order them,
+         * placing them before all of the others (in their original order).
+         *
+         * Returns 1 on success, else 0 (with a malloc failure). */
+static int pids_topk_select (
+        struct pids_stack *stacks[],
+        int numstacked,
+        int k,
+        QSR_t sortfunc,
+        struct sort_parms *parms)
+{
+    struct pids_stack **out;
+    int *heap, *chosen;
+    int i, j, n, tmp;
+
+    if (!(out = malloc(numstacked * sizeof(void *) + 2 * k * sizeof(int))))
+        return 0;
+    heap = (int *)(out + numstacked);
+    chosen = heap + k;
+
+    for (i = 0; i < k; i++)
+        heap[i] = i;
+    for (i = k / 2 - 1; i >= 0; i--)
+        pids_topk_siftdown(stacks, heap, k, i, sortfunc, parms);
+    for (i = k; i < numstacked; i++) {
+        if (pids_topk_worse(stacks, i, heap[0], sortfunc, parms))
+            continue;
+        heap[0] = i;
+        pids_topk_siftdown(stacks, heap, k, 0, sortfunc, parms);
+    }
+    memcpy(chosen, heap, k * sizeof(int));
+
+    // the usual heapsort, leaving the best k in their sorted order ...
+    for (n = k - 1; n > 0; n--) {
+        tmp = heap[0];
+        heap[0] = heap[n];
+        heap[n] = tmp;
+        pids_topk_siftdown(stacks, heap, n, 0, sortfunc, parms);
+    }
+    for (i = 0; i < k; i++)
+        out[i] = stacks[heap[i]];
+    // ... followed by everybody else, just as we found them
+    qsort(chosen, k, sizeof(int), pids_topk_cmpint);
+    for (i = j = 0, n = k; i < numstacked; i++) {
+        if (j < k && chosen[j] == i) {
+            ++j;
+            continue;
+        }
+        out[n++] = stacks[i];
+    }
+    memcpy(stacks, out, numstacked * sizeof(void *));
+    free(out);
+    return 1;
+} // end: pids_topk_select
+
+
 /*
  * pids_stacks_alloc():
  *
@@ -1220,6 +1692,48 @@ static struct stacks_extent *pids_stacks_alloc (
 } // end: pids_stacks_alloc
 
 
+        /*
+         * This guy is invoked by readproc.c after just the 'stat' file has
+         * been read.  Only those items deemed 'cheap' will have been valued
+         * when the user's filter function sees the stack.  Should it return
+         * zero, no other /proc/<pid> files will be read for this task. */
+static int pids_prefilter (
+        void *data,
+        proc_t *p)
+{
+    struct pids_info *info = data;
+    struct pids_stack *stack = info->filter_ext->stacks[0];
+    SET_t *that = info->filter_array;
+    int i, rc;
+
+    for (i = 0; that[i]; i++)
+        that[i](info, &stack->head[i], p);
+    rc = info->filter_func(stack, info->filter_data);
+
+    // the proc_t still owns that 'cmd' so we must forget it now
+    for (i = 0; that[i]; i++)
+        if (that[i] == (SET_t)set_pids_CMD_loan)
+            stack->head[i].result.str = NULL;
+    return rc;
+} // end: pids_prefilter
+
+
+static inline int pids_prefilter_prep (
+        struct pids_info *info,
+        PROCTAB *PT)
+{
+    PT->prefilter = NULL;
+    if (info->filter_func) {
+        if (!info->filter_ext
+        && !(info->filter_ext = pids_stacks_alloc(info, 1)))
+            return 0;        // here, errno was overridden with ENOMEM
+        PT->prefilter = pids_prefilter;
+        PT->prefilter_data = info;
+    }
+    return 1;
+} // end: pids_prefilter_prep
+
+
 static int pids_stacks_fetch (
         struct pids_info *info)
 {
@@ -1237,6 +1751,10 @@ static int pids_stacks_fetch (
         memcpy(info->fetch.anchor, ext->stacks, sizeof(void *) * STACKS_INIT);
         n_alloc = STACKS_INIT;
     }
+    /* any strings from the last fetch are now released all at once, since |
+       those stacks are about to be reused (their freefunc is thus NULL) .. | */
+    arena_reset(info->arena);
+    info->fetch_PT->arena = info->arena;
     pids_toggle_history(info);
     memset(&info->fetch.counts, 0, sizeof(struct pids_counts));
 
@@ -1281,6 +1799,317 @@ static int pids_stacks_fetch (
 } // end: pids_stacks_fetch
 
 
+// ___ Parallel Reap Support ||||||||||||||||||||||||||||||||||||||||||||||||||
+
+        /*
+         * When LIBPROC_REAP_THREADS asks for 2 or more threads, a reap will
+         * have the /proc directory listing split into contiguous shards read
+         * by that many persistent workers.  Each owns its PROCTAB (and thus
+         * the readproc.c thread local buffers) along with a proc_t and the
+         * stacks it fills.  Those stacks are then merged in shard order so
+         * that the results match what a single thread would have produced.
+         *
+         * History must be kept in that same order so only the few values it
+         * needs are saved by the workers.  The tallies and history are then
+         * done by the calling thread as part of that merge, after which any
+         * of the 'delta' items are simply valued again. */
+
+struct reap_hist {
+    TIC_t tics;                        // these are all that pids_proc_tally
+    unsigned long maj, min;            // and pids_make_hist will reference
+    unsigned long rbytes, wbytes, syscr, syscw, nvcsw, nivcsw;
+    unsigned long long start;
+    int tid;
+    char state;
+};
+
+struct reap_worker {
+    pthread_t thread;
+    sem_t beg, end;                    // work is available, work is complete
+    struct pids_info *info;            // the real context (for stacks alloc)
+    struct pids_info copy;             // for setsfunc use (hertz, seterr, etc)
+    pthread_mutex_t *lock;             // serializes pids_stacks_alloc calls
+    int quit;                          // time to go away
+    int rc;                            // outcome of the last fetch
+    int threads_too;                   // use readeither (vs. readproc)
+    pid_t *pids;                       // this shard's tgids, zero delimited
+    int pids_alloc;
+    proc_t proc;                       // that used by readproc/readeither
+    struct pids_stack **stacks;        // stacks filled by this worker
+    struct reap_hist *hist;            // parallels the above stacks
+    struct proc_arena *arena;          // owns those stacks' arena strings
+    int n_alloc;
+    int n_inuse;
+};
+
+struct reap_pool {
+    int n_workers;
+    pthread_mutex_t lock;
+    pid_t *pids;                       // the whole /proc directory listing
+    int pids_alloc;
+    struct reap_worker *workers;
+};
+
+
+static int pids_reap_worker_fetch (
+        struct reap_worker *w)
+{
+    proc_t*(*read_something)(PROCTAB*, proc_t*);
+    struct stacks_extent *ext;
+    PROCTAB *PT;
+    proc_t *p;
+
+    w->n_inuse = 0;
+    if (!w->pids[0])
+        return 0;
+    if (!w->arena && !(w->arena = arena_new()))
+        return -1;
+    if (!(PT = openproc(w->copy.oldflags | PROC_PID, w->pids)))
+        return -1;
+    PT->listed_tgids = 1;
+    arena_reset(w->arena);
+    PT->arena = w->arena;
+    read_something = w->threads_too ? readeither : readproc;
+
+    errno = 0;
+    while ((p = read_something(PT, &w->proc))) {
+        if (!(w->n_inuse < w->n_alloc)) {
+            w->n_alloc += STACKS_GROW;
+            if (!(w->stacks = realloc(w->stacks, sizeof(void *) * w->n_alloc))
+            || (!(w->hist = realloc(w->hist, sizeof(struct reap_hist) * w->n_alloc))))
+                goto oops;
+            pthread_mutex_lock(w->lock);
+            ext = pids_stacks_alloc(w->info, STACKS_GROW);
+            pthread_mutex_unlock(w->lock);
+            if (!ext)
+                goto oops;
+            memcpy(w->stacks + w->n_inuse, ext->stacks, sizeof(void *) * STACKS_GROW);
+        }
+        w->hist[w->n_inuse].tics  = p->utime + p->stime;
+        w->hist[w->n_inuse].maj   = p->maj_flt;
+        w->hist[w->n_inuse].min   = p->min_flt;
+        w->hist[w->n_inuse].rbytes = p->read_bytes;
+        w->hist[w->n_inuse].wbytes = p->write_bytes;
+        w->hist[w->n_inuse].syscr = p->syscr;
+        w->hist[w->n_inuse].syscw = p->syscw;
+        w->hist[w->n_inuse].nvcsw = p->nvcsw;
+        w->hist[w->n_inuse].nivcsw = p->nivcsw;
+        w->hist[w->n_inuse].start = p->start_time;
+        w->hist[w->n_inuse].tid   = p->tid;
+        w->hist[w->n_inuse].state = p->state;
+        if (!pids_assign_results(&w->copy, w->stacks[w->n_inuse++], p))
+            goto oops;
+    }
+    if (errno == ENOMEM)
+        goto oops;
+    closeproc(PT);
+    return 0;
+oops:
+    closeproc(PT);
+    return -1;
+} // end: pids_reap_worker_fetch
+
+
+static void *pids_reap_worker (
+        void *arg)
+{
+    struct reap_worker *w = arg;
+
+    for (;;) {
+        while (sem_wait(&w->beg) == -1 && errno == EINTR)
+            ;
+        if (w->quit)
+            break;
+        // each worker thread has its own container caches to collect
+        if (w->copy.containers_yes)
+            pids_containers_check();
+        w->rc = pids_reap_worker_fetch(w);
+        sem_post(&w->end);
+    }
+    // and its own caches to release, or they'd leak with this thread
+    readproc_free();
+    dev_to_tty_free();
+    return NULL;
+} // end: pids_reap_worker
+
+
+static void pids_reap_pool_free (
+        struct pids_info *info)
+{
+    struct reap_pool *pool = info->pool;
+    int i;
+
+    if (!pool)
+        return;
+    for (i = 0; i < pool->n_workers; i++) {
+        struct reap_worker *w = &pool->workers[i];
+        w->quit = 1;
+        sem_post(&w->beg);
+        pthread_join(w->thread, NULL);
+        sem_destroy(&w->beg);
+        sem_destroy(&w->end);
+        free(w->pids);
+        free(w->stacks);
+        free(w->hist);
+        arena_free(w->arena);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    free(pool->workers);
+    free(pool->pids);
+    free(pool);
+    info->pool = NULL;
+} // end: pids_reap_pool_free
+
+
+static int pids_reap_pool_new (
+        struct pids_info *info)
+{
+    struct reap_pool *pool;
+    sigset_t all, sav;
+    int i;
+
+    if (!(pool = calloc(1, sizeof(struct reap_pool))))
+        return 0;
+    if (!(pool->workers = calloc(info->reap_threads, sizeof(struct reap_worker)))) {
+        free(pool);
+        return 0;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    info->pool = pool;
+
+    // any signals are the business of our caller's threads, not ours
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &sav);
+    for (i = 0; i < info->reap_threads; i++) {
+        struct reap_worker *w = &pool->workers[i];
+        w->info = info;
+        w->lock = &pool->lock;
+        sem_init(&w->beg, 0, 0);
+        sem_init(&w->end, 0, 0);
+        if (pthread_create(&w->thread, NULL, pids_reap_worker, w)) {
+            sem_destroy(&w->beg);
+            sem_destroy(&w->end);
+            break;
+        }
+        pool->n_workers++;
+    }
+    pthread_sigmask(SIG_SETMASK, &sav, NULL);
+
+    if (pool->n_workers < 2) {
+        pids_reap_pool_free(info);
+        return 0;
+    }
+    return 1;
+} // end: pids_reap_pool_new
+
+
+        /*
+         * Since extents may have been freed (by a reset), this guy ensures
+         * that no worker will continue to reference any of those stacks. */
+static inline void pids_reap_pool_reset (
+        struct pids_info *info)
+{
+    int i;
+
+    if (info->pool) {
+        for (i = 0; i < info->pool->n_workers; i++)
+            info->pool->workers[i].n_alloc = 0;
+    }
+} // end: pids_reap_pool_reset
+
+
+static int pids_stacks_fetch_parallel (
+        struct pids_info *info,
+        enum pids_fetch_type which)
+{
+    struct reap_pool *pool = info->pool;
+    struct dirent *ent;
+    int i, j, k, n_pids, n_inuse, per;
+
+    // gather the directory listing (via 'reap' openproc) --
+    n_pids = 0;
+    while ((ent = readdir(info->fetch_PT->procfs))) {
+        if (*ent->d_name <= '0' || *ent->d_name > '9')
+            continue;
+        if (!(n_pids < pool->pids_alloc)) {
+            pool->pids_alloc += STACKS_INIT;
+            if (!(pool->pids = realloc(pool->pids, sizeof(pid_t) * pool->pids_alloc)))
+                return -1;
+        }
+        pool->pids[n_pids++] = strtoul(ent->d_name, NULL, 10);
+    }
+
+    // distribute the shards & release the workers ---------
+    per = (n_pids + pool->n_workers - 1) / pool->n_workers;
+    for (i = 0, k = 0; i < pool->n_workers; i++) {
+        struct reap_worker *w = &pool->workers[i];
+        int num = (n_pids - k < per) ? n_pids - k : per;
+        if (w->pids_alloc < num + 1) {
+            w->pids_alloc = num + 1;
+            if (!(w->pids = realloc(w->pids, sizeof(pid_t) * w->pids_alloc)))
+                return -1;
+        }
+        memcpy(w->pids, pool->pids + k, sizeof(pid_t) * num);
+        w->pids[num] = 0;
+        k += num;
+        memcpy(&w->copy, info, sizeof(struct pids_info));
+        w->threads_too = which;
+    }
+    for (i = 0; i < pool->n_workers; i++)
+        sem_post(&pool->workers[i].beg);
+    for (i = 0; i < pool->n_workers; i++)
+        while (sem_wait(&pool->workers[i].end) == -1 && errno == EINTR)
+            ;
+
+    // merge, with the tallies + history done in order -----
+    pids_toggle_history(info);
+    memset(&info->fetch.counts, 0, sizeof(struct pids_counts));
+    n_inuse = 0;
+    for (i = 0; i < pool->n_workers; i++) {
+        struct reap_worker *w = &pool->workers[i];
+        if (w->rc < 0) {
+            errno = ENOMEM;
+            return -1;
+        }
+        if (info->fetch.n_alloc_save < n_inuse + w->n_inuse + 1) {
+            info->fetch.n_alloc_save = n_inuse + w->n_inuse + 1;
+            if (!(info->fetch.results.stacks = realloc(info->fetch.results.stacks, sizeof(void *) * info->fetch.n_alloc_save)))
+                return -1;
+        }
+        for (j = 0; j < w->n_inuse; j++) {
+            struct pids_result *this = w->stacks[j]->head;
+            proc_t p;
+
+            memset(&p, 0, sizeof(proc_t));
+            p.utime   = w->hist[j].tics;
+            p.maj_flt = w->hist[j].maj;
+            p.min_flt = w->hist[j].min;
+            p.read_bytes = w->hist[j].rbytes;
+            p.write_bytes = w->hist[j].wbytes;
+            p.syscr   = w->hist[j].syscr;
+            p.syscw   = w->hist[j].syscw;
+            p.nvcsw   = w->hist[j].nvcsw;
+            p.nivcsw  = w->hist[j].nivcsw;
+            p.start_time = w->hist[j].start;
+            p.tid     = w->hist[j].tid;
+            p.state   = w->hist[j].state;
+            if (!pids_proc_tally(info, &info->fetch.counts, &p))
+                return -1;   // here, errno was set to ENOMEM
+            if (info->history_yes) {
+                for (k = 0; this[k].item < PIDS_logical_end; k++)
+                    if (Item_table[this[k].item].needhist)
+                        Item_table[this[k].item].setsfunc(info, &this[k], &p);
+            }
+            info->fetch.results.stacks[n_inuse++] = w->stacks[j];
+        }
+    }
+    info->fetch.results.stacks[n_inuse] = NULL;
+    info->fetch.n_inuse = n_inuse;
+
+    return n_inuse;     // callers beware, this might be zero !
+} // end: pids_stacks_fetch_parallel
+
+
 // ___ Public Functions |||||||||||||||||||||||||||||||||||||||||||||||||||||||
 
 // --- standard required functions --------------------------------------------
@@ -1299,6 +2128,7 @@ PROCPS_EXPORT int procps_pids_new (
         int numitems)
 {
     struct pids_info *p;
+    const char *env;
     int pgsz;
 
 #ifdef ITEMTABLE_DEBUG
@@ -1366,18 +2196,29 @@ PROCPS_EXPORT int procps_pids_new (
 
     if (!(p->hist = calloc(1, sizeof(struct history_info)))
     || (!(p->hist->PHist_new = calloc(NEWOLD_INIT, sizeof(HST_t))))
-    || (!(p->hist->PHist_sav = calloc(NEWOLD_INIT, sizeof(HST_t))))) {
+    || (!(p->hist->PHist_sav = calloc(NEWOLD_INIT, sizeof(HST_t))))
+    || (!pids_config_history(p))
+    || (!(p->arena = arena_new()))
+    || (!(p->get_arena = arena_new()))) {
         free(p->items);
+        arena_free(p->arena);          // (which might be NULL)
         if (p->hist) {
-            free(p->hist->PHist_sav);  // this & next might be NULL ...
+            free(p->hist->PHist_sav);  // this & next 3 might be NULL ...
             free(p->hist->PHist_new);
+            free(p->hist->PHash_sav);
+            free(p->hist->PHash_new);
             free(p->hist);
         }
         free(p);
         return -ENOMEM;
     }
     p->hist->HHist_siz = NEWOLD_INIT;
-    pids_config_history(p);
+
+    if ((env = getenv("LIBPROC_REAP_THREADS"))) {
+        p->reap_threads = atoi(env);
+        if (p->reap_threads > WORKERS_MAX)
+            p->reap_threads = WORKERS_MAX;
+    }
 
     pgsz = getpagesize();
     while (pgsz > 1024) { pgsz >>= 1; p->pgs2k_shift++; }
@@ -1416,6 +2257,7 @@ PROCPS_EXPORT int procps_pids_unref (
 #ifdef UNREF_RPTHASH
         pids_unref_rpthash(*info);
 #endif
+        pids_reap_pool_free(*info);
         if ((*info)->extents) {
             pids_cleanup_stacks_all(*info);
             do {
@@ -1428,7 +2270,7 @@ PROCPS_EXPORT int procps_pids_unref (
             struct stacks_extent *nextext, *ext = (*info)->otherexts;
             while (ext) {
                 nextext = ext->next;
-                pids_cleanup_stack(ext->stacks[0]->head);
+                pids_cleanup_stack(*info, ext->stacks[0]->head);
                 free(ext);
                 ext = nextext;
             };
@@ -1437,24 +2279,40 @@ PROCPS_EXPORT int procps_pids_unref (
             free((*info)->fetch.anchor);
         if ((*info)->fetch.results.stacks)
             free((*info)->fetch.results.stacks);
+        if ((*info)->columns.results.cols)
+            free((*info)->columns.results.cols);
+        if ((*info)->columns.values)
+            free((*info)->columns.values);
+        if ((*info)->sort_keys)
+            free((*info)->sort_keys);
 
         if ((*info)->items)
             free((*info)->items);
         if ((*info)->hist) {
             free((*info)->hist->PHist_sav);
             free((*info)->hist->PHist_new);
+            free((*info)->hist->PHash_sav);
+            free((*info)->hist->PHash_new);
             free((*info)->hist);
         }
+        arena_free((*info)->arena);
+        arena_free((*info)->get_arena);
 
         if ((*info)->get_ext)
            pids_oldproc_close(&(*info)->get_PT);
 
         if ((*info)->func_array)
             free((*info)->func_array);
+        if ((*info)->filter_array)
+            free((*info)->filter_array);
 
         if ((*info)->select_ids)
             free((*info)->select_ids);
 
+        pids_oldproc_close(&(*info)->sticky_PT);
+        if ((*info)->sticky_ids)
+            free((*info)->sticky_ids);
+
         numa_uninit();
 
         free(*info);
@@ -1517,6 +2375,8 @@ fresh_start:
         pids_oldproc_close(&info->get_PT);
         goto fresh_start;
     }
+    if (!pids_prefilter_prep(info, info->get_PT))
+        return NULL;
     errno = 0;
 
     if (info->containers_yes)
@@ -1526,6 +2386,8 @@ fresh_start:
     if (0 >= clock_gettime(CLOCK_BOOTTIME, &ts))
         info->boot_tics = (ts.tv_sec + ts.tv_nsec * 1.0e-9) * info->hertz;
 
+    arena_reset(info->get_arena);
+    info->get_PT->arena = info->get_arena;
     if (NULL == info->read_something(info->get_PT, &info->get_proc))
         return NULL;
     if (!pids_assign_results(info, info->get_ext->stacks[0], &info->get_proc))
@@ -1564,20 +2426,60 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_reap (
 
     if (!pids_oldproc_open(&info->fetch_PT, info->oldflags))
         return NULL;
+    if (!pids_prefilter_prep(info, info->fetch_PT)) {
+        pids_oldproc_close(&info->fetch_PT);
+        return NULL;
+    }
     info->read_something = which ? readeither : readproc;
 
     info->boot_tics = 0;
     if (0 >= clock_gettime(CLOCK_BOOTTIME, &ts))
         info->boot_tics = (ts.tv_sec + ts.tv_nsec * 1.0e-9) * info->hertz;
 
-    rc = pids_stacks_fetch(info);
+    /* a filter's stack is shared, so it forces one reap thread
+       ( and failing to launch those workers means the same ) */
+    if (info->reap_threads > 1 && !info->filter_func
+    && (info->pool || pids_reap_pool_new(info)))
+        rc = pids_stacks_fetch_parallel(info, which);
+    else
+        rc = pids_stacks_fetch(info);
 
     pids_oldproc_close(&info->fetch_PT);
-    // we better have found at least 1 pid
+    // we better have found at least 1 pid (unless a user filter is active)
+    if (rc == 0 && info->filter_func)
+        return &info->fetch.results;
     return (rc > 0) ? &info->fetch.results : NULL;
 } // end: procps_pids_reap
 
 
+/* procps_pids_reap_columns():
+ *
+ * Harvest all the available tasks/threads exactly like procps_pids_reap,
+ * but also provide each item's results as one contiguous array (such as
+ * every PIDS_VM_RSS in a single unsigned long[]) for those callers who'd
+ * sort, aggregate or export a column at a time.
+ *
+ * Those arrays, like the stacks they were copied from, remain valid only
+ * until the next reap, select or reset.  String pointers are not copied.
+ *
+ * Returns: pointer to a pids_columns struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct pids_columns *procps_pids_reap_columns (
+        struct pids_info *info,
+        enum pids_fetch_type which)
+{
+    struct pids_fetch *fetched;
+
+    if (!(fetched = procps_pids_reap(info, which)))
+        return NULL;
+    if (!pids_columns_fill(info, fetched)) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    return &info->columns.results;
+} // end: procps_pids_reap_columns
+
+
 PROCPS_EXPORT int procps_pids_reset (
         struct pids_info *info,
         enum pids_item *newitems,
@@ -1606,6 +2508,8 @@ PROCPS_EXPORT int procps_pids_reset (
            pids_oldproc_close(&info->get_PT);
            info->get_ext = NULL;
         }
+        info->filter_ext = NULL;
+        pids_reap_pool_reset(info);
         if (info->fetch.anchor) {
             free(info->fetch.anchor);
             info->fetch.anchor = NULL;
@@ -1673,6 +2577,10 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_select (
 
     if (!pids_oldproc_open(&info->fetch_PT, (info->oldflags | which), info->select_ids, numthese))
         return NULL;
+    if (!pids_prefilter_prep(info, info->fetch_PT)) {
+        pids_oldproc_close(&info->fetch_PT);
+        return NULL;
+    }
     info->read_something = (which & PIDS_FETCH_THREADS_TOO) ? readeither : readproc;
 
     info->boot_tics = 0;
@@ -1687,6 +2595,139 @@ PROCPS_EXPORT struct pids_fetch *procps_pids_select (
 } // end: procps_pids_select
 
 
+/* procps_pids_select_sticky():
+ *
+ * Like procps_pids_select, but for PIDS_SELECT_PID(_THREADS) only and with
+ * the intent that it be called repeatedly for the same pid list. Then the
+ * /proc directory fds, tgids and pidfds learned for those pids are kept so
+ * that subsequent calls must only read the files which satisfy the items.
+ *
+ * Changing the pids, their order or number (or the items via 'reset') will
+ * simply start anew.
+ *
+ * Returns: pointer to a pids_fetch struct on success, NULL on error.
+ */
+PROCPS_EXPORT struct pids_fetch *procps_pids_select_sticky (
+        struct pids_info *info,
+        unsigned *these,
+        int numthese,
+        enum pids_select_type which)
+{
+    struct timespec ts;
+    unsigned flags;
+    int rc;
+
+    errno = EINVAL;
+    if (info == NULL || these == NULL)
+        return NULL;
+    if (numthese < 1)
+        return NULL;
+    if (which != PIDS_SELECT_PID && which != PIDS_SELECT_PID_THREADS)
+        return NULL;
+    if (!info->maxitems)
+        return NULL;
+    errno = 0;
+
+    if (info->containers_yes)
+        pids_containers_check();
+
+    flags = info->oldflags | which;
+    if (info->sticky_PT
+    && (flags != info->sticky_flags
+    || numthese != info->sticky_num
+    || memcmp(info->sticky_ids, these, sizeof(unsigned) * numthese)))
+        pids_oldproc_close(&info->sticky_PT);
+
+    if (info->sticky_PT)
+        rewindproc(info->sticky_PT);
+    else {
+        // the zero delimiter is needed by the old library
+        if (!(info->sticky_ids = realloc(info->sticky_ids, sizeof(unsigned) * (numthese + 1))))
+            return NULL;
+        memcpy(info->sticky_ids, these, sizeof(unsigned) * numthese);
+        info->sticky_ids[numthese] = 0;
+        info->sticky_num = numthese;
+        info->sticky_flags = flags;
+        if (!pids_oldproc_open(&info->sticky_PT, flags, info->sticky_ids, numthese))
+            return NULL;
+        if (!stickyproc(info->sticky_PT)) {
+            pids_oldproc_close(&info->sticky_PT);
+            return NULL;
+        }
+    }
+    if (!pids_prefilter_prep(info, info->sticky_PT))
+        return NULL;
+    info->read_something = (which & PIDS_FETCH_THREADS_TOO) ? readeither : readproc;
+
+    info->boot_tics = 0;
+    if (0 >= clock_gettime(CLOCK_BOOTTIME, &ts))
+        info->boot_tics = (ts.tv_sec + ts.tv_nsec * 1.0e-9) * info->hertz;
+
+    // a loan, so that select & reap will not close it
+    info->fetch_PT = info->sticky_PT;
+    rc = pids_stacks_fetch(info);
+    info->fetch_PT = NULL;
+
+    // no guarantee any pids were found
+    return (rc >= 0) ? &info->fetch.results : NULL;
+} // end: procps_pids_select_sticky
+
+
+/*
+ * procps_pids_filter():
+ *
+ * Establish (or with a NULL func, remove) a predicate to be applied to every
+ * task before all but its 'stat' file have been read.  The stack passed to
+ * that function contains only those items available from 'stat' or the task's
+ * directory (ids, state, cmd, times, etc.).  All other results will be zero.
+ *
+ * When the function returns zero, the task is ignored by subsequent 'get',
+ * 'reap' and 'select' calls.  It will not be included in any counts nor will
+ * any additional files be read for it.
+ *
+ * Returns: < 0 on failure, 0 on success
+ */
+PROCPS_EXPORT int procps_pids_filter (
+        struct pids_info *info,
+        pids_filter_t func,
+        void *data)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    info->filter_func = func;
+    info->filter_data = data;
+    return 0;
+} // end: procps_pids_filter
+
+
+/*
+ * procps_pids_borrow():
+ *
+ * When 'yes' is non-zero, those string results otherwise strdup'd for each
+ * task (signals, tty and wchan names, etc.) will instead be borrowed from
+ * library storage valid only until the next 'get' (for a 'get' stack) or
+ * the next 'reap' or 'select' (for those stacks). This is meant for read
+ * only consumers, sparing a malloc and free for every such result.
+ *
+ * Any string results currently held in stacks are released by this call.
+ *
+ * Returns: < 0 on failure, 0 on success
+ */
+PROCPS_EXPORT int procps_pids_borrow (
+        struct pids_info *info,
+        int yes)
+{
+    if (info == NULL)
+        return -EINVAL;
+
+    // prior results must be released by the rules under which they were made
+    pids_cleanup_stacks_all(info);
+    info->borrow = (yes != 0);
+    return 0;
+} // end: procps_pids_borrow
+
+
 /*
  * procps_pids_sort():
  *
@@ -1705,7 +2746,6 @@ PROCPS_EXPORT struct pids_stack **procps_pids_sort (
         enum pids_sort_order order)
 {
     struct sort_parms parms;
-    struct pids_result *p;
     int offset;
 
     errno = EINVAL;
@@ -1719,29 +2759,95 @@ PROCPS_EXPORT struct pids_stack **procps_pids_sort (
     if (numstacked < 2)
         return stacks;
 
-    offset = 0;
-    p = stacks[0]->head;
-    for (;;) {
-        if (p->item == sortitem)
-            break;
-        ++offset;
-        if (offset >= info->maxitems)
-            return NULL;
-        if (p->item >= PIDS_logical_end)
-            return NULL;
-        ++p;
-    }
+    if (0 > (offset = pids_sort_offset(info, stacks[0], sortitem)))
+        return NULL;
     errno = 0;
 
     parms.offset = offset;
     parms.order = order;
 
-    if (!mergesort_r(stacks, numstacked, (QSR_t)Item_table[p->item].sortfunc, &parms))
+    if (pids_sort_radix(info, stacks, numstacked, Item_table[sortitem].sortfunc, &parms))
+        return stacks;
+    if (!mergesort_r(stacks, numstacked, (QSR_t)Item_table[sortitem].sortfunc, &parms))
         return NULL;
     return stacks;
 } // end: procps_pids_sort
 
 
+/*
+ * procps_pids_topk():
+ *
+ * Like procps_pids_sort, but only the first 'k' stacks are guaranteed
+ * to be sorted.  They'll be exactly those (in the same order) that a
+ * procps_pids_sort would have provided.  All the remaining stacks will
+ * follow, but in no particular order.
+ *
+ * This is much cheaper than a full sort when only the leading stacks
+ * are to be shown (as with a single screen of tasks).
+ *
+ * Returns those same addresses, the first 'k' sorted.
+ *
+ * Note: all of the stacks must be homogeneous (of equal length and content).
+ */
+PROCPS_EXPORT struct pids_stack **procps_pids_topk (
+        struct pids_info *info,
+        struct pids_stack *stacks[],
+        int numstacked,
+        int k,
+        enum pids_item sortitem,
+        enum pids_sort_order order)
+{
+    struct sort_parms parms;
+    int offset;
+
+    errno = EINVAL;
+    if (info == NULL || stacks == NULL || k < 0)
+        return NULL;
+    // a pids_item is currently unsigned, but we'll protect our future
+    if (sortitem < 0  || sortitem >= PIDS_logical_end)
+        return NULL;
+    if (order != PIDS_SORT_ASCEND && order != PIDS_SORT_DESCEND)
+        return NULL;
+    // with most of them wanted, a real sort is likely to be faster
+    if (k >= numstacked / 2)
+        return procps_pids_sort(info, stacks, numstacked, sortitem, order);
+    if (k < 1)
+        return stacks;
+
+    if (0 > (offset = pids_sort_offset(info, stacks[0], sortitem)))
+        return NULL;
+    errno = 0;
+
+    parms.offset = offset;
+    parms.order = order;
+
+    if (!pids_topk_select(stacks, numstacked, k, Item_table[sortitem].sortfunc, &parms))
+        return NULL;
+    return stacks;
+} // end: procps_pids_topk
+
+
+/*
+ * procps_pids_hist_stats():
+ *
+ * Report on the hash tables behind the history used by those 'delta'
+ * items (and pcpu), as of the most recent reap or select. It exists to
+ * help diagnose performance with very large numbers of tasks.
+ *
+ * Returns: < 0 on failure, 0 on success
+ */
+PROCPS_EXPORT int procps_pids_hist_stats (
+        struct pids_info *info,
+        struct pids_hist_stats *stats)
+{
+    if (info == NULL || stats == NULL)
+        return -EINVAL;
+
+    pids_hist_tally(info, stats);
+    return 0;
+} // end: procps_pids_hist_stats
+
+
 // --- special debugging function(s) ------------------------------------------
 /*
  *  The following isn't part of the normal programming interface.  Rather,
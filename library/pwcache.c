@@ -24,6 +24,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <errno.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/types.h>
@@ -39,8 +40,53 @@
 #define HASHSIZE  64              /* power of 2 */
 #define HASH(x)   ((x) & (HASHSIZE - 1))
 
+#define PWBUFMIN  1024
+#define PWBUFMAX  (1024 * 1024)
+
 static char ERRname[] = "?";
 
+    // getpwuid & getgrgid share a static buffer, which a parallel reap's
+    // workers would race upon, so these reentrant forms are used instead
+    // ( the thread local buffer grows for groups with large member lists )
+static __thread char *pwbuf_str;
+static __thread size_t pwbuf_siz;
+
+static int pwbuf_grow (void) {
+    size_t siz = pwbuf_siz ? pwbuf_siz * 2 : PWBUFMIN;
+    char *str;
+
+    if (siz > PWBUFMAX || !(str = realloc(pwbuf_str, siz)))
+        return 0;
+    pwbuf_str = str;
+    pwbuf_siz = siz;
+    return 1;
+}
+
+static struct passwd *pwbuf_getpwuid (uid_t uid, struct passwd *pwd) {
+    struct passwd *pw = NULL;
+    int rc;
+
+    if (!pwbuf_str && !pwbuf_grow())
+        return NULL;
+    while (ERANGE == (rc = getpwuid_r(uid, pwd, pwbuf_str, pwbuf_siz, &pw)))
+        if (!pwbuf_grow())
+            return NULL;
+    return rc ? NULL : pw;
+}
+
+static struct group *pwbuf_getgrgid (gid_t gid, struct group *grp) {
+    struct group *gr = NULL;
+    int rc;
+
+    if (!pwbuf_str && !pwbuf_grow())
+        return NULL;
+    while (ERANGE == (rc = getgrgid_r(gid, grp, pwbuf_str, pwbuf_siz, &gr)))
+        if (!pwbuf_grow())
+            return NULL;
+    return rc ? NULL : gr;
+}
+
+
 static __thread struct pwbuf {
     struct pwbuf *next;
     uid_t uid;
@@ -49,7 +95,7 @@ static __thread struct pwbuf {
 
 char *pwcache_get_user(uid_t uid) {
     struct pwbuf **p;
-    struct passwd *pw;
+    struct passwd pwd, *pw;
 
     p = &pwhash[HASH(uid)];
     while (*p) {
@@ -60,7 +106,7 @@ char *pwcache_get_user(uid_t uid) {
     if (!(*p = (struct pwbuf *)malloc(sizeof(struct pwbuf))))
         return ERRname;
     (*p)->uid = uid;
-    pw = getpwuid(uid);
+    pw = pwbuf_getpwuid(uid, &pwd);
     if(!pw || strlen(pw->pw_name) >= P_G_SZ || pw->pw_name[0] == '\0')
         sprintf((*p)->name, "%u", uid);
     else
@@ -78,7 +124,7 @@ static __thread struct grpbuf {
 
 char *pwcache_get_group(gid_t gid) {
     struct grpbuf **g;
-    struct group *gr;
+    struct group grp, *gr;
 
     g = &grphash[HASH(gid)];
     while (*g) {
@@ -89,7 +135,7 @@ char *pwcache_get_group(gid_t gid) {
     if (!(*g = (struct grpbuf *)malloc(sizeof(struct grpbuf))))
         return ERRname;
     (*g)->gid = gid;
-    gr = getgrgid(gid);
+    gr = pwbuf_getgrgid(gid, &grp);
     if (!gr || strnlen(gr->gr_name, P_G_SZ) >= P_G_SZ || gr->gr_name[0] == '\0')
         snprintf((*g)->name, P_G_SZ, "%u", gid);
     else
@@ -97,3 +143,24 @@ char *pwcache_get_group(gid_t gid) {
     (*g)->next = NULL;
     return((*g)->name);
 }
+
+    // release this thread's caches (as a thread ends)
+void pwcache_free(void) {
+    struct pwbuf *p;
+    struct grpbuf *g;
+    int i;
+
+    for (i = 0; i < HASHSIZE; i++) {
+        while ((p = pwhash[i])) {
+            pwhash[i] = p->next;
+            free(p);
+        }
+        while ((g = grphash[i])) {
+            grphash[i] = g->next;
+            free(g);
+        }
+    }
+    free(pwbuf_str);
+    pwbuf_str = NULL;
+    pwbuf_siz = 0;
+}
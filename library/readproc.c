@@ -33,6 +33,7 @@
 #include <signal.h>
 #include <fcntl.h>
 #include <dirent.h>
+#include <poll.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/syscall.h>
@@ -77,20 +78,108 @@ struct utlbuf_s {
     int   siz;     // current len of the above
 } utlbuf_s;
 
+// file2str() buffers kept by the readproc functions, see readproc_free()
+static __thread struct utlbuf_s strvec_ub, proc_ub, task_ub, tgid_ub;
+
 static int task_dir_missing;
 
 char *str_none = "-";
 
+
+//////////////////////////////////////////////////////////////////////////////////
+// An arena is a chain of ever larger blocks, each carved up in turn, with all of
+// those strings then given back at once. Only the newest (largest) block is kept
+// by arena_reset so, after a few cycles, one block serves all the proc_t's read
+// (thus there's no malloc/free per string, as is the case without an arena).
+
+#define ARENA_MIN  (1024*64)
+
+struct arena_blk {
+    struct arena_blk *next;      // those filled before this one
+    size_t siz, used;
+    char data[];
+};
+
+struct proc_arena {
+    struct arena_blk *blks;      // the newest (and largest) first
+};
+
+
+struct proc_arena *arena_new (void) {
+    return calloc(1, sizeof(struct proc_arena));
+}
+
+
+void arena_reset (struct proc_arena *arena) {
+    struct arena_blk *blk;
+
+    if (!arena || !arena->blks)
+        return;
+    while ((blk = arena->blks->next)) {
+        arena->blks->next = blk->next;
+        free(blk);
+    }
+    arena->blks->used = 0;
+}
+
+
+void arena_free (struct proc_arena *arena) {
+    if (!arena)
+        return;
+    arena_reset(arena);
+    free(arena->blks);
+    free(arena);
+}
+
+
+void *arena_alloc (struct proc_arena *arena, size_t size) {
+    struct arena_blk *blk;
+    size_t siz;
+
+    if (!arena)
+        return malloc(size);
+    size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    blk = arena->blks;
+    if (!blk || blk->siz - blk->used < size) {
+        for (siz = blk ? blk->siz * 2 : ARENA_MIN; siz < size; siz *= 2)
+            ;
+        if (!(blk = malloc(sizeof(struct arena_blk) + siz)))
+            return NULL;
+        blk->siz = siz;
+        blk->used = 0;
+        blk->next = arena->blks;
+        arena->blks = blk;
+    }
+    blk->used += size;
+    return blk->data + blk->used - size;
+}
+
+
+char *arena_strdup (struct proc_arena *arena, const char *str) {
+    size_t len = strlen(str) + 1;
+    char *new;
+
+    if ((new = arena_alloc(arena, len)))
+        memcpy(new, str, len);
+    return new;
+}
+
+#undef ARENA_MIN
+
+
 // free any additional dynamically acquired storage associated with a proc_t
 static inline void free_acquired (proc_t *p) {
+    struct proc_arena *arena = p->arena;
     /*
      * here we free those items that might exist even when not explicitly |
      * requested by our caller.  it is expected that pid.c will then free |
-     * any remaining dynamic memory which might be dangling off a proc_t. | */
-    if (p->cmd)    free(p->cmd);
-    if (p->cgname) free(p->cgname);
-
-    if (p->cgroup   && p->cgroup   != str_none)  free(p->cgroup);
+     * any remaining dynamic memory which might be dangling off a proc_t. |
+     * ( those strings that came from an arena are released by its owner )| */
+    if (!arena) {
+        if (p->cmd)    free(p->cmd);
+        if (p->cgname) free(p->cgname);
+        if (p->cgroup  && p->cgroup  != str_none)  free(p->cgroup);
+    }
     if (p->sd_mach  && p->sd_mach  != str_none)  free(p->sd_mach);
     if (p->sd_ouid  && p->sd_ouid  != str_none)  free(p->sd_ouid);
     if (p->sd_seat  && p->sd_seat  != str_none)  free(p->sd_seat);
@@ -110,6 +199,7 @@ static inline void free_acquired (proc_t *p) {
         = p->supgid = p->supgrp
 #endif
         = str_none;
+    p->arena = arena;
 }
 
 static void close_dirfd(int *fd)
@@ -148,7 +238,7 @@ static DIR* opendirat(
 ///////////////////////////////////////////////////////////////////////////
 
 typedef struct status_table_struct {
-    unsigned char name[8];        // /proc/*/status field name
+    const char *name;             // /proc/*/status field name
     unsigned char len;            // name length
 #ifdef LABEL_OFFSET
     long offset;                  // jump address offset
@@ -238,7 +328,8 @@ static int status2proc (char *S, proc_t *restrict P, int is_proc) {
       NUL NUL NUL
       F(CapPrm)
       F(Uid)
-      NUL NUL NUL
+      F(nonvoluntary_ctxt_switches)
+      NUL NUL
       F(SigIgn)
       F(SigQ)
       NUL NUL NUL
@@ -263,6 +354,8 @@ static int status2proc (char *S, proc_t *restrict P, int is_proc) {
       F(RssAnon)
       NUL NUL NUL NUL
       F(RssFile)
+      NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL NUL
+      F(voluntary_ctxt_switches)
     };
 
 #undef F
@@ -318,7 +411,7 @@ ENTER(0x220);
         raw[u] = '\0';
         if (!P->cmd) {
             escape_str(buf, raw, sizeof(buf));
-            if (!(P->cmd = strdup(buf))) return 1;
+            if (!(P->cmd = arena_strdup(P->arena, buf))) return 1;
         }
         S--;   // put back the '\n' or '\0'
         continue;
@@ -407,6 +500,12 @@ ENTER(0x220);
     case_VmSwap: // Linux 2.6.34
         P->vm_swap = (unsigned long)strtol(S,&S,10);
         continue;
+    case_voluntary_ctxt_switches:
+        P->nvcsw = strtoul(S,&S,10);
+        continue;
+    case_nonvoluntary_ctxt_switches:
+        P->nivcsw = strtoul(S,&S,10);
+        continue;
     case_Groups:
     {   char *ss = S, *nl = strchr(S, '\n');
         size_t j;
@@ -618,7 +717,7 @@ ENTER(0x160);
        memcpy(raw, S, num);
        raw[num] = '\0';
        escape_str(buf, raw, sizeof(buf));
-       if (!(P->cmd = strdup(buf))) return 1;
+       if (!(P->cmd = arena_strdup(P->arena, buf))) return 1;
     }
     S = tmp + 2;                 // skip ") "
 
@@ -747,9 +846,9 @@ static void smaps2proc (const char *s, proc_t *restrict P) {
   #undef mkOBJ
 }
 
-static int file2str(int dirfd, const char *what, struct utlbuf_s *ub) {
+static int fd2str(int fd, struct utlbuf_s *ub) {
  #define buffGRW 1024
-    int fd, num, tot_read = 0;
+    int num, tot_read = 0;
 
     /* on first use we preallocate a buffer of minimum size to emulate
        former 'local static' behavior -- even if this read fails, that
@@ -760,28 +859,154 @@ static int file2str(int dirfd, const char *what, struct utlbuf_s *ub) {
         ub->buf = calloc(1, (ub->siz = buffGRW));
         if (!ub->buf) return -1;
     }
-    if (-1 == (fd = openat(dirfd, what, O_RDONLY, 0))) return -1;
-    while (0 < (num = read(fd, ub->buf + tot_read, ub->siz - tot_read))) {
+    if (fd < 0) return -1;
+    // pread, since a read plan's fd will be reused across refresh cycles
+    while (0 < (num = pread(fd, ub->buf + tot_read, ub->siz - tot_read, tot_read))) {
         tot_read += num;
         if (tot_read < ub->siz) break;
         if (ub->siz >= INT_MAX - buffGRW) {
             tot_read--;
             break;
         }
-        if (!(ub->buf = realloc(ub->buf, (ub->siz += buffGRW)))) {
-            close(fd);
+        if (!(ub->buf = realloc(ub->buf, (ub->siz += buffGRW))))
             return -1;
-        }
     };
     ub->buf[tot_read] = '\0';
-    close(fd);
     if (tot_read < 1) return -1;
     return tot_read;
  #undef buffGRW
 }
 
 
-static char **file2strvec(int dirfd, const char *what) {
+static int file2str(int dirfd, const char *what, struct utlbuf_s *ub) {
+    int fd, rc;
+
+    fd = openat(dirfd, what, O_RDONLY, 0);
+    rc = fd2str(fd, ub);
+    if (fd != -1) close(fd);
+    return rc;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+// The "read plan" is the fixed, ordered set of single buffer files wanted for
+// each process, computed once by openproc from the flags. With PROC_PID lists
+// those files' fds are also kept open (by pid) for as long as a listed scan is
+// open, so a file read more than once (status, say) is opened just the once.
+// They're all closed with the last such closeproc, since the caller can't know
+// about them. Fds meant to outlive a scan are the job of stickyproc/rewindproc.
+
+enum plan_file {
+    PLAN_stat, PLAN_io, PLAN_smaps, PLAN_statm, PLAN_status,
+    PLAN_oom, PLAN_oomadj, PLAN_cgroup, PLAN_end
+};
+
+static const struct {
+    const char *name;
+    unsigned    flags;       // any of these wants the file, 0 means always
+} plan_files[] = {
+    { "stat",          0                                },
+    { "io",            PROC_FILLIO                      },
+    { "smaps_rollup",  PROC_FILLSMAPS                   },
+    { "statm",         PROC_FILLMEM                     },
+    { "status",        PROC_FILLSTATUS                  },
+    { "oom_score",     PROC_FILLOOM                     },
+    { "oom_score_adj", PROC_FILLOOM                     },
+    { "cgroup",        PROC_FILL_LXC | PROC_FILL_DOCKER },
+};
+
+#define PLAN_PIDS_MAX  64        // beyond this, a listed pid won't keep fds
+
+struct plan_fds {
+    pid_t    pid;
+    int      fds[PLAN_end];
+};
+
+    // entries are never moved while any PROC_PID PROCTAB remains open
+static __thread struct plan_fds plan_cache[PLAN_PIDS_MAX];
+static __thread int plan_used;
+static __thread int plan_users;
+
+
+static unsigned plan_compute (unsigned flags) {
+    unsigned plan = 0;
+    int i;
+
+    for (i = 0; i < PLAN_end; i++)
+        if (!plan_files[i].flags || (flags & plan_files[i].flags))
+            plan |= 1u << i;
+    return plan;
+}
+
+
+static void plan_entry_close (struct plan_fds *ent, unsigned keep) {
+    int i;
+
+    for (i = 0; i < PLAN_end; i++) {
+        if (ent->fds[i] != -1 && !(keep & (1u << i))) {
+            close(ent->fds[i]);
+            ent->fds[i] = -1;
+        }
+    }
+}
+
+
+    // forget every pid, closing all of their fds
+static void plan_forget (void) {
+    int i;
+
+    for (i = 0; i < plan_used; i++)
+        plan_entry_close(&plan_cache[i], 0);
+    plan_used = 0;
+}
+
+
+    // with a sticky PROCTAB, the 'ent' is provided and owned by its caller
+static void plan_visit (PROCTAB *PT, pid_t pid, struct plan_fds *ent) {
+    int i;
+
+    PT->planfds = NULL;
+    if (!PT->plan_kept || PT->listed_tgids || PT->pidfd < 0)
+        return;
+    for (i = 0; !ent && i < plan_used; i++) {
+        if (plan_cache[i].pid == pid) {
+            ent = &plan_cache[i];
+            break;
+        }
+    }
+    if (!ent) {
+        if (plan_used >= PLAN_PIDS_MAX)
+            return;
+        ent = &plan_cache[plan_used++];
+        ent->pid = pid;
+        for (i = 0; i < PLAN_end; i++)
+            ent->fds[i] = -1;
+    }
+    // unless sticky, 'status' is always wanted by listed_tgid
+    plan_entry_close(ent, PT->plan | (PT->sticky ? 0 : 1u << PLAN_status));
+    PT->planfds = ent;
+}
+
+
+static int plan2str (PROCTAB *PT, enum plan_file which, struct utlbuf_s *ub) {
+    struct plan_fds *ent = PT->planfds;
+    int rc;
+
+    if (!ent)
+        return file2str(PT->pidfd, plan_files[which].name, ub);
+    if (ent->fds[which] != -1) {
+        if (-1 != (rc = fd2str(ent->fds[which], ub)))
+            return rc;
+        // that task is gone, so try whatever now owns the pid (if anything)
+        close(ent->fds[which]);
+        ent->fds[which] = -1;
+    }
+    ent->fds[which] = openat(PT->pidfd, plan_files[which].name, O_RDONLY | O_CLOEXEC);
+    return fd2str(ent->fds[which], ub);
+}
+
+
+static char **file2strvec(proc_t *P, int dirfd, const char *what) {
     char buf[2048];     /* read buf bytes at a time */
     char *p, *rbuf = 0, *endbuf, **q, **ret, *strp;
     int fd, tot = 0, n, c, end_of_file = 0;
@@ -812,21 +1037,23 @@ static char **file2strvec(int dirfd, const char *what) {
             buf[n++] = '\0';                    /* so append null-terminator */
 
         if (n <= 0) break;         /* unneeded (end_of_file = 1) but avoid realloc */
-        rbuf = realloc(rbuf, tot + n);          /* allocate more memory */
-        if (!rbuf) {
-            close(fd);
-            return NULL;
+        if (tot + n > strvec_ub.siz) {          /* allocate more memory */
+            if (!(rbuf = realloc(strvec_ub.buf, tot + n + sizeof(buf)))) {
+                close(fd);
+                return NULL;
+            }
+            strvec_ub.buf = rbuf;
+            strvec_ub.siz = tot + n + sizeof(buf);
         }
+        rbuf = strvec_ub.buf;
         memcpy(rbuf + tot, buf, n);             /* copy buffer into it */
         tot += n;                               /* increment total byte ctr */
         if (end_of_file)
             break;
     }
     close(fd);
-    if (n < 0 || tot <= 0) {       /* error, or nothing read */
-        if (rbuf) free(rbuf);
+    if (n < 0 || tot <= 0)         /* error, or nothing read */
         return NULL;               /* read error */
-    }
 
     rbuf[tot-1] = '\0';            /* belt and suspenders (the while loop did it, too) */
     endbuf = rbuf + tot;           /* count space for pointers */
@@ -841,8 +1068,10 @@ static char **file2strvec(int dirfd, const char *what) {
             *p = 0;
     }
 
-    rbuf = realloc(rbuf, tot + c + align);      /* make room for ptrs AT END */
-    if (!rbuf) return NULL;
+    /* that read buffer is kept for next time, with just the result copied
+       (including room for ptrs AT END) to the proc_t's arena, if it has one */
+    if (!(p = arena_alloc(P->arena, tot + c + align))) return NULL;
+    rbuf = memcpy(p, rbuf, tot);
     endbuf = rbuf + tot;                        /* addr just past data buf */
     q = ret = (char**) (endbuf+align);          /* ==> free(*ret) to dealloc */
     for (strp = p = rbuf; p < endbuf; p++) {
@@ -902,7 +1131,7 @@ static int read_unvectored(char *restrict const dst, unsigned sz, int dirfd, con
 }
 
 
-char **vectorize_this_str (const char *src) {
+char **vectorize_this_str (struct proc_arena *arena, const char *src) {
  #define pSZ  (sizeof(char*))
     char *cpy, **vec;
     size_t adj, tot;
@@ -910,21 +1139,22 @@ char **vectorize_this_str (const char *src) {
     tot = strlen(src) + 1;                       // prep for our vectors
     if (tot < 1 || tot >= INT_MAX) tot = INT_MAX-1; // integer overflow?
     adj = (pSZ-1) - ((tot + pSZ-1) & (pSZ-1));   // calc alignment bytes
-    cpy = calloc(1, tot + adj + (2 * pSZ));      // get new larger buffer
+    cpy = arena_alloc(arena, tot + adj + (2 * pSZ)); // get new larger buffer
     if (!cpy) return NULL;                       // oops, looks like ENOMEM
     snprintf(cpy, tot, "%s", src);               // duplicate their string
     vec = (char**)(cpy + tot + adj);             // prep pointer to pointers
     *vec = cpy;                                  // point 1st vector to string
     *(vec+1) = NULL;                             // null ptr 'list' delimit
     return vec;                                  // ==> free(*vec) to dealloc
+                                                 //  ( if not from an arena )
  #undef pSZ
 }
 
 
     // This littl' guy just serves those true vectorized fields
     // ( when a /proc source field didn't exist )
-static int vectorize_dash_rc (char ***vec) {
-    if (!(*vec = vectorize_this_str(str_none)))
+static int vectorize_dash_rc (struct proc_arena *arena, char ***vec) {
+    if (!(*vec = vectorize_this_str(arena, str_none)))
         return 1;
     return 0;
 }
@@ -954,13 +1184,13 @@ static int fill_cgroup_cvt (int dirfd, proc_t *restrict p) {
         dst += escape_str(dst, grp, vMAX);
     }
     if (dst_buffer[0]) {
-        if (!(p->cgroup = strdup(dst_buffer)))
+        if (!(p->cgroup = arena_strdup(p->arena, dst_buffer)))
             return 1;
     } else
         p->cgroup = str_none;
     name = strstr(p->cgroup, ":name=");
     if (name && *(name+6)) name += 6; else name = p->cgroup;
-    if (!(p->cgname = strdup(name)))
+    if (!(p->cgname = arena_strdup(p->arena, name)))
         return 1;
     return 0;
  #undef vMAX
@@ -977,7 +1207,7 @@ static int fill_cmdline_cvt (int dirfd, proc_t *restrict p) {
     else
         escape_command(dst_buffer, p, MAX_BUFSZ, uFLG);
     if (dst_buffer[0]) {
-        if (!(p->cmdline = strdup(dst_buffer)))
+        if (!(p->cmdline = arena_strdup(p->arena, dst_buffer)))
             return 1;
     } else
         p->cmdline = str_none;
@@ -993,7 +1223,7 @@ static int fill_environ_cvt (int dirfd, proc_t *restrict p) {
     if (read_unvectored(src_buffer, MAX_BUFSZ, dirfd, "environ", ' '))
         escape_str(dst_buffer, src_buffer, MAX_BUFSZ);
     if (dst_buffer[0]) {
-        if (!(p->environ = strdup(dst_buffer)))
+        if (!(p->environ = arena_strdup(p->arena, dst_buffer)))
             return 1;
     } else
         p->environ = str_none;
@@ -1169,14 +1399,14 @@ static int login_uid (const int dirfd) {
 }
 
 
-static char *readlink_exe (const int dirfd){
+static char *readlink_exe (const int dirfd, proc_t *p){
     int in;
 
     in = (int)readlinkat(dirfd, "exe", src_buffer, MAX_BUFSZ);
     if (in > 0) {
         src_buffer[in] = '\0';
         escape_str(dst_buffer, src_buffer, MAX_BUFSZ);
-        return strdup(dst_buffer);
+        return arena_strdup(p->arena, dst_buffer);
     }
     return str_none;
 }
@@ -1238,7 +1468,6 @@ static inline void stat_fd (int dirfd, proc_t *p) {
 // The pid (tgid? tid?) is already in p, and a path to it in path, with some
 // room to spare.
 static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict const p) {
-    static __thread struct utlbuf_s ub = { NULL, 0 };    // buf for stat,statm,status,cgroup
     static __thread struct stat sb;     // stat() buffer
     unsigned flags = PT->flags;
     int rc = 0;
@@ -1255,33 +1484,40 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
     /* this attempted read of 'stat' is now unconditional to ensure a 'cmd' name
        as a minimum. this prevents a NULL 'cmdline' pointer for kernel threads
        in case the 'status' file is missing or not otherwise read ... */
-    if (file2str(PT->pidfd, "stat", &ub) == -1)
+    if (plan2str(PT, PLAN_stat, &proc_ub) == -1)
         goto next_proc;
-    rc += stat2proc(ub.buf, p);
+    rc += stat2proc(proc_ub.buf, p);
 
     if (PT->hide_kernel && (p->ppid == 2 || p->tid == 2)) {
         free_acquired(p);
         goto next_proc;
     }
 
+    /* with only the 'stat' and fstat() data now available, a caller can opt
+       to reject this process before any of the more expensive files are read */
+    if (PT->prefilter && !PT->prefilter(PT->prefilter_data, p)) {
+        free_acquired(p);
+        goto next_proc;
+    }
+
     if (flags & PROC_FILLIO) {                  // read /proc/#/io
-        if (file2str(PT->pidfd, "io", &ub) != -1)
-            io2proc(ub.buf, p);
+        if (plan2str(PT, PLAN_io, &proc_ub) != -1)
+            io2proc(proc_ub.buf, p);
     }
 
     if (flags & PROC_FILLSMAPS) {               // read /proc/#/smaps_rollup
-        if (file2str(PT->pidfd, "smaps_rollup", &ub) != -1)
-            smaps2proc(ub.buf, p);
+        if (plan2str(PT, PLAN_smaps, &proc_ub) != -1)
+            smaps2proc(proc_ub.buf, p);
     }
 
     if (flags & PROC_FILLMEM) {                 // read /proc/#/statm
-        if (file2str(PT->pidfd, "statm", &ub) != -1)
-            statm2proc(ub.buf, p);
+        if (plan2str(PT, PLAN_statm, &proc_ub) != -1)
+            statm2proc(proc_ub.buf, p);
     }
 
     if (flags & PROC_FILLSTATUS) {              // read /proc/#/status
-        if (file2str(PT->pidfd, "status", &ub) != -1){
-            rc += status2proc(ub.buf, p, 1);
+        if (plan2str(PT, PLAN_status, &proc_ub) != -1){
+            rc += status2proc(proc_ub.buf, p, 1);
             if (flags & (PROC_FILL_SUPGRP & ~PROC_FILLSTATUS))
                 rc += supgrps_from_supgids(p);
             if (flags & (PROC_FILL_OUSERS & ~PROC_FILLSTATUS)) {
@@ -1309,28 +1545,28 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
         p->egroup = pwcache_get_group(p->egid);
 
     if (flags & PROC_FILLENV)                   // read /proc/#/environ
-        if (!(p->environ_v = file2strvec(PT->pidfd, "environ")))
-            rc += vectorize_dash_rc(&p->environ_v);
+        if (!(p->environ_v = file2strvec(p, PT->pidfd, "environ")))
+            rc += vectorize_dash_rc(p->arena, &p->environ_v);
     if (flags & PROC_EDITENVRCVT)
         rc += fill_environ_cvt(PT->pidfd, p);
 
     if (flags & PROC_FILLARG)                   // read /proc/#/cmdline
-        if (!(p->cmdline_v = file2strvec(PT->pidfd, "cmdline")))
-            rc += vectorize_dash_rc(&p->cmdline_v);
+        if (!(p->cmdline_v = file2strvec(p, PT->pidfd, "cmdline")))
+            rc += vectorize_dash_rc(p->arena, &p->cmdline_v);
     if (flags & PROC_EDITCMDLCVT)
         rc += fill_cmdline_cvt(PT->pidfd, p);
 
     if ((flags & PROC_FILLCGROUP))              // read /proc/#/cgroup
-        if (!(p->cgroup_v = file2strvec(PT->pidfd, "cgroup")))
-            rc += vectorize_dash_rc(&p->cgroup_v);
+        if (!(p->cgroup_v = file2strvec(p, PT->pidfd, "cgroup")))
+            rc += vectorize_dash_rc(p->arena, &p->cgroup_v);
     if (flags & PROC_EDITCGRPCVT)
         rc += fill_cgroup_cvt(PT->pidfd, p);
 
     if (flags & PROC_FILLOOM) {
-        if (file2str(PT->pidfd, "oom_score", &ub) != -1)
-            oomscore2proc(ub.buf, p);
-        if (file2str(PT->pidfd, "oom_score_adj", &ub) != -1)
-            oomadj2proc(ub.buf, p);
+        if (plan2str(PT, PLAN_oom, &proc_ub) != -1)
+            oomscore2proc(proc_ub.buf, p);
+        if (plan2str(PT, PLAN_oomadj, &proc_ub) != -1)
+            oomadj2proc(proc_ub.buf, p);
     }
 
     if (flags & PROC_FILLNS)                    // read /proc/#/ns/*
@@ -1342,11 +1578,11 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
 
     if (flags & (PROC_FILL_LXC | PROC_FILL_DOCKER)) {
         // ok if nothing is read, an empty buffer will do just fine ...
-        file2str(PT->pidfd, "cgroup", &ub);
+        plan2str(PT, PLAN_cgroup, &proc_ub);
         if (flags & PROC_FILL_LXC)              // value the lxc name
-            p->lxcname = lxc_containers(&ub);
+            p->lxcname = lxc_containers(&proc_ub);
         if (flags & PROC_FILL_DOCKER) {         // value the dockerids
-            struct docker_ids *ids = docker_containers(&ub);
+            struct docker_ids *ids = docker_containers(&proc_ub);
             p->dockerid = ids->id;
             p->dockerid_64 = ids->id_64;
         }
@@ -1356,7 +1592,7 @@ static proc_t *simple_readproc(PROCTAB *restrict const PT, proc_t *restrict cons
         p->luid = login_uid(PT->pidfd);
 
     if (flags & PROC_FILL_EXE) {
-        if (!(p->exe = readlink_exe(PT->pidfd)))
+        if (!(p->exe = readlink_exe(PT->pidfd, p)))
             rc += 1;
     }
 
@@ -1379,7 +1615,6 @@ next_proc:
 // t is the POSIX thread  (task group member, generally not the leader)
 // path is a path to the task, with some room to spare.
 static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict const t) {
-    static __thread struct utlbuf_s ub = { NULL, 0 };    // buf for stat,statm,status.cgroup
     static __thread struct stat sb;     // stat() buffer
     unsigned flags = PT->flags;
     int rc = 0;
@@ -1396,33 +1631,40 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
     /* this attempted read of 'stat' is now unconditional to ensure a 'cmd' name
        as a minimum. this prevents a NULL 'cmdline' pointer for kernel threads
        in case the 'status' file is missing or not otherwise read ... */
-    if (file2str(PT->taskfd, "stat", &ub) == -1)
+    if (file2str(PT->taskfd, "stat", &task_ub) == -1)
         goto next_task;
-    rc += stat2proc(ub.buf, t);
+    rc += stat2proc(task_ub.buf, t);
 
     if (PT->hide_kernel && (t->ppid == 2 || t->tid == 2)) {
         free_acquired(t);
         goto next_task;
     }
 
+    /* as above, but readeither must know that sibling threads remain */
+    if (PT->prefilter && !PT->prefilter(PT->prefilter_data, t)) {
+        free_acquired(t);
+        PT->vetoed = 1;
+        goto next_task;
+    }
+
     if (flags & PROC_FILLIO) {                  // read /proc/#/task/#/io
-        if (file2str(PT->taskfd, "io", &ub) != -1)
-            io2proc(ub.buf, t);
+        if (file2str(PT->taskfd, "io", &task_ub) != -1)
+            io2proc(task_ub.buf, t);
     }
 
     if (flags & PROC_FILLSMAPS) {               // read /proc/#/task/#/smaps_rollup
-        if (file2str(PT->taskfd, "smaps_rollup", &ub) != -1)
-            smaps2proc(ub.buf, t);
+        if (file2str(PT->taskfd, "smaps_rollup", &task_ub) != -1)
+            smaps2proc(task_ub.buf, t);
     }
 
     if (flags & PROC_FILLMEM) {                 // read /proc/#/task/#/statm
-        if (file2str(PT->taskfd, "statm", &ub) != -1)
-            statm2proc(ub.buf, t);
+        if (file2str(PT->taskfd, "statm", &task_ub) != -1)
+            statm2proc(task_ub.buf, t);
     }
 
     if (flags & PROC_FILLSTATUS) {              // read /proc/#/task/#/status
-        if (file2str(PT->taskfd, "status", &ub) != -1) {
-            rc += status2proc(ub.buf, t, 0);
+        if (file2str(PT->taskfd, "status", &task_ub) != -1) {
+            rc += status2proc(task_ub.buf, t, 0);
             if (flags & (PROC_FILL_SUPGRP & ~PROC_FILLSTATUS))
                 rc += supgrps_from_supgids(t);
             if (flags & (PROC_FILL_OUSERS & ~PROC_FILLSTATUS)) {
@@ -1446,20 +1688,20 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
         t->egroup = pwcache_get_group(t->egid);
 
     if (flags & PROC_FILLARG)                   // read /proc/#/task/#/cmdline
-        if (!(t->cmdline_v = file2strvec(PT->taskfd, "cmdline")))
-            rc += vectorize_dash_rc(&t->cmdline_v);
+        if (!(t->cmdline_v = file2strvec(t, PT->taskfd, "cmdline")))
+            rc += vectorize_dash_rc(t->arena, &t->cmdline_v);
     if (flags & PROC_EDITCMDLCVT)
         rc += fill_cmdline_cvt(PT->taskfd, t);
 
     if (flags & PROC_FILLENV)                   // read /proc/#/task/#/environ
-        if (!(t->environ_v = file2strvec(PT->taskfd, "environ")))
-            rc += vectorize_dash_rc(&t->environ_v);
+        if (!(t->environ_v = file2strvec(t, PT->taskfd, "environ")))
+            rc += vectorize_dash_rc(t->arena, &t->environ_v);
     if (flags & PROC_EDITENVRCVT)
         rc += fill_environ_cvt(PT->taskfd, t);
 
     if ((flags & PROC_FILLCGROUP))              // read /proc/#/task/#/cgroup
-        if (!(t->cgroup_v = file2strvec(PT->taskfd, "cgroup")))
-            rc += vectorize_dash_rc(&t->cgroup_v);
+        if (!(t->cgroup_v = file2strvec(t, PT->taskfd, "cgroup")))
+            rc += vectorize_dash_rc(t->arena, &t->cgroup_v);
     if (flags & PROC_EDITCGRPCVT)
         rc += fill_cgroup_cvt(PT->taskfd, t);
 
@@ -1467,26 +1709,26 @@ static proc_t *simple_readtask(PROCTAB *restrict const PT, proc_t *restrict cons
         rc += sd2proc(t);
 
     if (flags & PROC_FILL_EXE) {
-        if (!(t->exe = readlink_exe(PT->taskfd)))
+        if (!(t->exe = readlink_exe(PT->taskfd, t)))
             rc += 1;
     }
 
     if (flags & PROC_FILLOOM) {
-        if (file2str(PT->taskfd, "oom_score", &ub) != -1)
-            oomscore2proc(ub.buf, t);
-        if (file2str(PT->taskfd, "oom_score_adj", &ub) != -1)
-            oomadj2proc(ub.buf, t);
+        if (file2str(PT->taskfd, "oom_score", &task_ub) != -1)
+            oomscore2proc(task_ub.buf, t);
+        if (file2str(PT->taskfd, "oom_score_adj", &task_ub) != -1)
+            oomadj2proc(task_ub.buf, t);
     }
     if (flags & PROC_FILLNS)                    // read /proc/#/task/#/ns/*
         procps_ns_read_pid(t->tid, &(t->ns));
 
     if (flags & (PROC_FILL_LXC | PROC_FILL_DOCKER)) {
         // ok if nothing is read, an empty buffer will do just fine ...
-        file2str(PT->taskfd, "cgroup", &ub);
+        file2str(PT->taskfd, "cgroup", &task_ub);
         if (flags & PROC_FILL_LXC)              // value the lxc name
-            t->lxcname = lxc_containers(&ub);
+            t->lxcname = lxc_containers(&task_ub);
         if (flags & PROC_FILL_DOCKER) {         // value the dockerids
-            struct docker_ids *ids = docker_containers(&ub);
+            struct docker_ids *ids = docker_containers(&task_ub);
             t->dockerid = ids->id;
             t->dockerid_64 = ids->id_64;
         }
@@ -1526,7 +1768,7 @@ static int simple_nextpid(PROCTAB *restrict const PT, proc_t *restrict const p)
             if (errno == 0) {
                 p->tid = p->tgid;
                 snprintf(path, PROCPATHLEN, "/proc/%d", p->tgid);
-                PT->pidfd = open(path, O_RDONLY | O_DIRECTORY);
+                PT->pidfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
                 return 1;
             }
         }
@@ -1565,30 +1807,102 @@ static int simple_nexttid(PROCTAB *restrict const PT, const proc_t *restrict con
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////
+// The 'status' file is the only place where we find a task's real tgid.
+// It's a bit expensive, but remember we're dealing with fewer processes,
+// unlike the other 'next' guys (plus we need not parse the whole thing
+// like status2proc)! ( unless that list was built from /proc, thus all tgids )
+static pid_t listed_tgid (PROCTAB *PT, pid_t pid) {
+  char *str;
+
+  if (!PT->listed_tgids
+  && plan2str(PT, PLAN_status, &tgid_ub) != -1
+  && (str = strstr(tgid_ub.buf, "Tgid:")))
+    return atoi(str + 5);          // this tgid is the proper one |
+  return pid;                      // this tgid may be a huge fib |
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////
+// When 'sticky', what is learned about each listed pid is kept for rewindproc:
+// its /proc directory fd, its tgid and a pidfd, which becomes readable should
+// that process end (thus no chance a reused pid could fool us). Without such
+// a pidfd, nothing is kept and the pid is treated anew with every rewindproc.
+
+struct sticky_pid {
+  int   dirfd;                     // the /proc/<pid> directory, or -1
+  pid_t tgid;                      // as obtained from its 'status' file
+  struct plan_fds plan;            // that read plan's fds for this pid
+};
+
+static int sticky_pidfd (pid_t pid) {
+#ifdef SYS_pidfd_open
+  return syscall(SYS_pidfd_open, pid, 0);
+#else
+  (void)pid;
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+
+static void sticky_forget (PROCTAB *PT, int i) {
+  if (PT->sticky_pids[i].dirfd != -1)
+    close(PT->sticky_pids[i].dirfd);
+  if (PT->sticky_polls[i].fd != -1)
+    close(PT->sticky_polls[i].fd);
+  PT->sticky_pids[i].dirfd = -1;
+  PT->sticky_polls[i].fd = -1;
+  plan_entry_close(&PT->sticky_pids[i].plan, 0);
+}
+
+
+static int sticky_nextpid (PROCTAB *PT, proc_t *p, pid_t pid) {
+  int i = PT->pids - PT->pids_head - 1;
+  struct sticky_pid *sp = &PT->sticky_pids[i];
+  char path[PROCPATHLEN];
+
+  PT->pidfd = -1;                  // they're owned by the sticky_pids
+  PT->planfds = NULL;
+  if (pid <= 0)
+    return pid;
+
+  if (sp->dirfd == -1) {
+    sticky_forget(PT, i);
+    // pidfd first, so a pid reused before the open is seen as ended
+    PT->sticky_polls[i].fd = sticky_pidfd(pid);
+    snprintf(path, PROCPATHLEN, "/proc/%d", pid);
+    sp->dirfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    PT->pidfd = sp->dirfd;
+    plan_visit(PT, pid, &sp->plan);
+    sp->tgid = listed_tgid(PT, pid);
+  } else {
+    PT->pidfd = sp->dirfd;
+    plan_visit(PT, pid, &sp->plan);
+  }
+  p->tid = pid;
+  p->tgid = sp->tgid;
+  return pid;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////
 // This "finds" processes in a list that was given to openproc().
 // Return non-zero on success. (tgid is a real headache)
 static int listed_nextpid (PROCTAB *PT, proc_t *p) {
-  static __thread struct utlbuf_s ub = { NULL, 0 };
   pid_t pid = *(PT->pids)++;
   char path[PROCPATHLEN];
 
+  if (PT->sticky)
+    return sticky_nextpid(PT, p, pid);
   close_dirfd(&(PT->pidfd));
+  PT->planfds = NULL;
   if (pid > 0) {
     snprintf(path, PROCPATHLEN, "/proc/%d", pid);
-    PT->pidfd = open(path, O_RDONLY | O_DIRECTORY);
-    p->tid = p->tgid = pid;        // this tgid may be a huge fib |
-
-    /* the 'status' directory is the only place where we find the |
-       task's real tgid. it's a bit expensive, but remember we're |
-       dealing with fewer processes, unlike the other 'next' guys |
-       (plus we need not parse the whole thing like status2proc)! | */
-
-    if (file2str(PT->pidfd, "status", &ub) != -1) {
-      char *str = strstr(ub.buf, "Tgid:");
-      if (str)
-        p->tgid = atoi(str + 5);   // this tgid is the proper one |
-    }
+    PT->pidfd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    plan_visit(PT, pid, NULL);
+    p->tid = pid;
+    p->tgid = listed_tgid(PT, pid);
   }
   return pid;
 }
@@ -1609,6 +1923,7 @@ proc_t *readproc(PROCTAB *restrict const PT, proc_t *restrict p) {
   proc_t *ret;
 
   free_acquired(p);
+  p->arena = PT->arena;
 
   for(;;){
     // fills in p->tid and p->tgid
@@ -1635,6 +1950,7 @@ proc_t *readeither (PROCTAB *restrict const PT, proc_t *restrict x) {
     proc_t *ret;
 
     free_acquired(x);
+    x->arena = PT->arena;
 
     if (new_p) {
         if (new_p->tid != canary) new_p = NULL;
@@ -1654,6 +1970,10 @@ next_task:
     // fills in our path, plus x->tid and x->tgid
     if ((!(PT->taskfinder(PT,&skel_p,x)))             // simple_nexttid
     || (!(ret = PT->taskreader(PT,x)))) {             // simple_readtask
+        if (PT->vetoed) {                             // (just this one task)
+            PT->vetoed = 0;
+            goto next_task;
+        }
         goto next_proc;
     }
     if (!new_p) {
@@ -1702,10 +2022,11 @@ PROCTAB *openproc(unsigned flags, ...) {
         PT->finder = simple_nextpid;
     }
     PT->flags = flags;
+    PT->plan = plan_compute(flags);
 
     va_start(ap, flags);
     if (flags & PROC_PID)
-        PT->pids = va_arg(ap, pid_t*);
+        PT->pids = PT->pids_head = va_arg(ap, pid_t*);
     else if (flags & PROC_UID){
         PT->uids = va_arg(ap, uid_t*);
         PT->nuid = va_arg(ap, int);
@@ -1725,26 +2046,122 @@ PROCTAB *openproc(unsigned flags, ...) {
     && !(dst_buffer = malloc(MAX_BUFSZ))) {
         if (PT->procfs) closedir(PT->procfs);
         free(src_buffer);
+        src_buffer = NULL;
         free(PT);
         return NULL;
     }
+    if (flags & PROC_PID) {
+        PT->plan_kept = 1;
+        ++plan_users;
+    }
 
     return PT;
 }
 
 
+// keep what's learned about each pid of a PROC_PID scan, for rewindproc
+int stickyproc(PROCTAB *PT) {
+    int i, j, n = 0;
+
+    if (!PT || !(PT->flags & PROC_PID) || PT->pids != PT->pids_head) {
+        errno = EINVAL;
+        return 0;
+    }
+    if (PT->sticky)
+        return 1;
+    while (PT->pids_head[n] > 0)
+        n++;
+    if (!(PT->sticky_pids = calloc(n + 1, sizeof(struct sticky_pid)))
+    || !(PT->sticky_polls = calloc(n + 1, sizeof(struct pollfd)))) {
+        free(PT->sticky_pids);
+        PT->sticky_pids = NULL;
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        PT->sticky_pids[i].dirfd = -1;
+        PT->sticky_pids[i].plan.pid = PT->pids_head[i];
+        for (j = 0; j < PLAN_end; j++)
+            PT->sticky_pids[i].plan.fds[j] = -1;
+        PT->sticky_polls[i].fd = -1;
+        PT->sticky_polls[i].events = POLLIN;
+    }
+    PT->sticky_num = n;
+    close_dirfd(&(PT->pidfd));
+    PT->sticky = 1;
+    return 1;
+}
+
+
+// restart a sticky scan, forgetting only those pids whose processes ended
+void rewindproc(PROCTAB *PT) {
+    int i;
+
+    if (!PT || !PT->sticky)
+        return;
+    // one poll for all pidfds, the ended (or unknown) processes are readable
+    if (0 < poll(PT->sticky_polls, PT->sticky_num, 0)) {
+        for (i = 0; i < PT->sticky_num; i++)
+            if (PT->sticky_polls[i].revents)
+                sticky_forget(PT, i);
+    }
+    for (i = 0; i < PT->sticky_num; i++)
+        if (PT->sticky_polls[i].fd == -1)
+            sticky_forget(PT, i);
+    if (PT->taskdir) closedir(PT->taskdir);
+    PT->taskdir = NULL;
+    PT->taskdir_user = -2;
+    close_dirfd(&(PT->taskfd));
+    PT->pidfd = -1;
+    PT->planfds = NULL;
+    PT->vetoed = 0;
+    PT->pids = PT->pids_head;
+}
+
+
 // terminate a process table scan
 void closeproc(PROCTAB *PT) {
+    int i;
+
     if (PT){
         if (PT->procfs) closedir(PT->procfs);
         if (PT->taskdir) closedir(PT->taskdir);
+        if (PT->sticky) {
+            PT->pidfd = -1;             // it was owned by a sticky_pid
+            for (i = 0; i < PT->sticky_num; i++)
+                sticky_forget(PT, i);
+            free(PT->sticky_pids);
+            free(PT->sticky_polls);
+        }
         close_dirfd(&(PT->pidfd));
         close_dirfd(&(PT->taskfd));
+        // with the last listed scan closed, no fds are left behind
+        if (PT->plan_kept && !--plan_users)
+            plan_forget();
         free(PT);
     }
 }
 
 
+// Release the buffers and caches the calling thread built up while reading,
+// for a thread which is about to end (after its last closeproc).
+void readproc_free(void) {
+    struct utlbuf_s *ubs[] = { &strvec_ub, &proc_ub, &task_ub, &tgid_ub };
+    unsigned i;
+
+    for (i = 0; i < sizeof(ubs) / sizeof(ubs[0]); i++) {
+        free(ubs[i]->buf);
+        ubs[i]->buf = NULL;
+        ubs[i]->siz = 0;
+    }
+    free(src_buffer);
+    free(dst_buffer);
+    src_buffer = dst_buffer = NULL;
+    lxc_containers(NULL);
+    docker_containers(NULL);
+    pwcache_free();
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////
 int look_up_our_self(void) {
     struct utlbuf_s ub = { NULL, 0 };
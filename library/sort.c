@@ -33,7 +33,7 @@
  *
  * but, we return 1 on success or 0 on malloc failure! |
  * plus we issue only a single malloc each invocation! |
- * plus we issue, at most, one memcpy each invocation! |
+ * plus we merge natural runs, so sorted input is O(n) |
  *
  * Note:
  *   This guy deals EXCLUSIVELY with sorting pointers. |
@@ -49,50 +49,74 @@ int mergesort_r (
         void *arg)
 {
     void *aux;
-    char **src, **next_src, **dst;
-    size_t top_start, bottom_start, bottom_end, half_depth, t, b;
+    char **src, **dst, **tmp;
+    size_t *ends, runs, r, n, top_start, bottom_start, bottom_end, t, b;
 
     if (nmemb < 2) return 1;
 
-    // allocate one auxiliary buffer for the entire sort
-    if (!(aux = malloc(nmemb * sizeof(void *))))
-        return 0;
-
+    // already sorted? then we needn't even bother with that malloc
     src = base;
-    dst = next_src = aux;
+    for (b = 1; b < nmemb && compar(src + b - 1, src + b, arg) <= 0; b++)
+        ;
+    if (b >= nmemb) return 1;
 
-    // bottom-up merge sort
-    for (half_depth = 1; half_depth < nmemb; half_depth *= 2) {
+    /* allocate one auxiliary buffer for the entire sort, which
+       also holds where each of the (ascending) runs will end */
+    if (!(aux = malloc(nmemb * (sizeof(void *) + sizeof(size_t)))))
+        return 0;
+    dst = aux;
+    ends = (size_t *)(dst + nmemb);
 
-        for (top_start = 0; top_start < nmemb; top_start += 2 * half_depth) {
-            bottom_start = (top_start + half_depth < nmemb) ? top_start + half_depth : nmemb;
-            bottom_end = (top_start + (2 * half_depth) < nmemb) ? top_start + (2 * half_depth) : nmemb;
+    // find the natural runs (where input is nearly sorted there are few)
+    for (runs = 0, t = b; ; t++) {
+        if (t >= nmemb || compar(src + t - 1, src + t, arg) > 0)
+            ends[runs++] = t;
+        if (t >= nmemb) break;
+    }
 
+    // bottom-up merge sort, but of those runs (merging each pair)
+    while (runs > 1) {
+        top_start = 0;
+        for (r = n = 0; r < runs; r += 2) {
+            if (r + 1 >= runs) {
+                // an odd man out, just copy him
+                memcpy(dst + top_start, src + top_start
+                    , (ends[r] - top_start) * sizeof(void *));
+                ends[n++] = ends[r];
+                break;
+            }
+            bottom_start = ends[r];
+            bottom_end = ends[r + 1];
+            tmp = dst + top_start;
             t = top_start;
             b = bottom_start;
 
             // merge two sorted halves into buffer
             while (t < bottom_start && b < bottom_end) {
                 if (compar(src + t, src + b, arg) <= 0)
-                    *dst = *(src + t++);
+                    *tmp = *(src + t++);
                 else
-                    *dst = *(src + b++);
-                dst++;
+                    *tmp = *(src + b++);
+                tmp++;
             }
 
             // copy remaining top stuff
             while (t < bottom_start)
-                *(dst++) = *(src + t++);
+                *(tmp++) = *(src + t++);
 
             // copy remaining bottom stuff
             while (b < bottom_end)
-                *(dst++) = *(src + b++);
+                *(tmp++) = *(src + b++);
+
+            ends[n++] = bottom_end;
+            top_start = bottom_end;
         }
+        runs = n;
 
         // swap roles of src and dst
+        tmp = dst;
         dst = src;
-        src = next_src;
-        next_src = dst;
+        src = tmp;
     }
 
     // if sorted data is in aux, copy back to base
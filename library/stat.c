@@ -750,11 +750,61 @@ static int stat_make_numa_hist (
 } // end: stat_make_numa_hist
 
 
+        /*
+         * This guy and the one that follows replace what had been several
+         * sscanf calls, which became costly with very many cpus. Like the
+         * "%llu" conversion (less any sign), he'll skip leading blanks and
+         * then value a number, returning the address following its digits.
+         * But should there be no digits he returns NULL (num is unchanged). */
+static inline const char *stat_parse_digits (
+        const char *bp,
+        unsigned long long *num)
+{
+    unsigned long long n = 0;
+
+    while (*bp == ' ' || *bp == '\t')
+        ++bp;
+    if (*bp < '0' || *bp > '9')
+        return NULL;
+    do
+        n = n * 10 + (*bp++ - '0');
+    while (*bp >= '0' && *bp <= '9');
+    *num = n;
+    return bp;
+} // end: stat_parse_digits
+
+
+static int stat_parse_jifs (
+        const char *bp,
+        struct stat_jifs *jifs)
+{
+    unsigned long long *const cols[] = {
+        &jifs->user,  &jifs->nice,   &jifs->system, &jifs->idle,
+        &jifs->iowait, &jifs->irq,   &jifs->sirq,   &jifs->stolen,
+        &jifs->guest, &jifs->gnice };
+    int n;
+
+    // since a newline is never skipped, we'll stop at the end of this line
+    for (n = 0; n < (int)MAXTABLE(cols); n++)
+        if (!(bp = stat_parse_digits(bp, cols[n])))
+            break;
+    return n;
+} // end: stat_parse_jifs
+
+
 static int stat_read_failed (
         struct stat_info *info)
 {
+    static const struct {
+        const char *key;
+        int len;
+    } sys_keys[] = {
+        { "intr ", 5 }, { "ctxt ", 5 }, { "btime ", 6 },
+        { "processes ", 10 }, { "procs_blocked ", 14 }, { "procs_running ", 14 } };
+    unsigned long long sys_nums[MAXTABLE(sys_keys)];
     struct hist_tic *sum_ptr, *cpu_ptr;
-    char *bp, *b;
+    const char *b;
+    char *bp;
     int i, rc, num, tot_read;
     unsigned long long llnum;
     int refresh_cores = 0;
@@ -811,14 +861,10 @@ static int stat_read_failed (
 
     // now value the cpu summary tics from line #1
 #ifdef __CYGWIN__
-    if (4 > sscanf(bp, "cpu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu"
+    if (strncmp(bp, "cpu ", 4) || 4 > stat_parse_jifs(bp + 4, &sum_ptr->new)) {
 #else
-    if (8 > sscanf(bp, "cpu %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu"
+    if (strncmp(bp, "cpu ", 4) || 8 > stat_parse_jifs(bp + 4, &sum_ptr->new)) {
 #endif
-        , &sum_ptr->new.user,  &sum_ptr->new.nice,   &sum_ptr->new.system
-        , &sum_ptr->new.idle,  &sum_ptr->new.iowait, &sum_ptr->new.irq
-        , &sum_ptr->new.sirq,  &sum_ptr->new.stolen
-        , &sum_ptr->new.guest, &sum_ptr->new.gnice)) {
             errno = ERANGE;
             return 1;
     }
@@ -843,16 +889,17 @@ reap_em_again:
         cpu_ptr->numa_node = STAT_NODE_INVALID;
         cpu_ptr->count = 1;
 
+        rc = 0;
+        if (!strncmp(bp, "cpu", 3)
+        && (b = stat_parse_digits(bp + 3, &llnum))) {
+            cpu_ptr->id = llnum;
+            rc = 1 + stat_parse_jifs(b, &cpu_ptr->new);
+        }
 #ifdef __CYGWIN__
-        if (4 > (rc = sscanf(bp, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu"
+        if (4 > rc) {
 #else
-        if (8 > (rc = sscanf(bp, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu"
+        if (8 > rc) {
 #endif
-            , &cpu_ptr->id
-            , &cpu_ptr->new.user,  &cpu_ptr->new.nice,   &cpu_ptr->new.system
-            , &cpu_ptr->new.idle,  &cpu_ptr->new.iowait, &cpu_ptr->new.irq
-            , &cpu_ptr->new.sirq,  &cpu_ptr->new.stolen
-            , &cpu_ptr->new.guest, &cpu_ptr->new.gnice))) {
                 break;                   // we must tolerate cpus taken offline
         }
         stat_derive_unique(cpu_ptr);
@@ -889,37 +936,25 @@ reap_em_again:
     // remember sys_hist stuff from last time around
     memcpy(&info->sys_hist.old, &info->sys_hist.new, sizeof(struct stat_data));
 
-    llnum = 0;
-    if ((b = strstr(bp, "intr ")))
-        sscanf(b,  "intr %llu", &llnum);
-    info->sys_hist.new.intr = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "ctxt ")))
-        sscanf(b,  "ctxt %llu", &llnum);
-    info->sys_hist.new.ctxt = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "btime ")))
-        sscanf(b,  "btime %llu", &llnum);
-    info->sys_hist.new.btime = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "processes ")))
-        sscanf(b,  "processes %llu", &llnum);
-    info->sys_hist.new.procs_created = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "procs_blocked ")))
-        sscanf(b,  "procs_blocked %llu", &llnum);
-    info->sys_hist.new.procs_blocked = llnum;
-
-    llnum = 0;
-    if ((b = strstr(bp, "procs_running ")))
-        sscanf(b,  "procs_running %llu", &llnum);
-    if (llnum)
-        llnum--; //exclude itself
-    info->sys_hist.new.procs_running = llnum;
+    /* the remaining lines of interest are found in a single pass, avoiding |
+       a rescan of that (often huge) intr line for each of the other fields | */
+    memset(sys_nums, 0, sizeof(sys_nums));
+    for (b = bp; b && *b; b = (b = strchr(b, '\n')) ? b + 1 : NULL) {
+        for (i = 0; i < (int)MAXTABLE(sys_keys); i++) {
+            if (!strncmp(b, sys_keys[i].key, sys_keys[i].len)) {
+                stat_parse_digits(b + sys_keys[i].len, &sys_nums[i]);
+                break;
+            }
+        }
+    }
+    info->sys_hist.new.intr = sys_nums[0];
+    info->sys_hist.new.ctxt = sys_nums[1];
+    info->sys_hist.new.btime = sys_nums[2];
+    info->sys_hist.new.procs_created = sys_nums[3];
+    info->sys_hist.new.procs_blocked = sys_nums[4];
+    if (sys_nums[5])
+        sys_nums[5]--; //exclude itself
+    info->sys_hist.new.procs_running = sys_nums[5];
 
     if (refresh_cores) {
         stat_cores_reset(info);
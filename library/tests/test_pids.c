@@ -19,6 +19,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #include "pids.h"
 #include "tests.h"
@@ -60,11 +66,404 @@ int check_fatal_proc_unmounted(void *data)
 	    ( PIDS_VAL(1, ul_int, stack) > 0));
 }
 
+static int filter_self(struct pids_stack *stack, void *data)
+{
+    int *vm_rss_seen = data;
+
+    if (PIDS_VAL(1, ul_int, stack))
+        *vm_rss_seen = 1;
+    return PIDS_VAL(0, s_int, stack) == getpid();
+}
+
+int check_pids_filter(void *data)
+{
+    struct pids_info *info = NULL;
+    struct pids_fetch *reap;
+    int vm_rss_seen = 0;
+    testname = "procps_pids_filter() reap yields only self";
+
+    return ( (procps_pids_new(&info, items2, 2) == 0) &&
+            (procps_pids_filter(info, filter_self, &vm_rss_seen) == 0) &&
+            ( (reap = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)) != NULL) &&
+            ( reap->counts->total == 1) &&
+            ( PIDS_VAL(0, s_int, reap->stacks[0]) == getpid()) &&
+            ( PIDS_VAL(1, ul_int, reap->stacks[0]) > 0) &&
+            ( vm_rss_seen == 0) &&
+            (procps_pids_unref(&info) == 0));
+}
+
+/* fork a paused child whose pid is 'want', by walking through the whole
+ * pid space (which ns_last_pid, if permitted, makes unnecessary) */
+static pid_t fork_reusing(pid_t want)
+{
+    char buf[32];
+    int fd, max = 0, i;
+    pid_t pid;
+
+    if ((fd = open("/proc/sys/kernel/ns_last_pid", O_WRONLY)) != -1) {
+        snprintf(buf, sizeof(buf), "%d", want - 1);
+        // should this fail, we'll just take the long way around
+        i = write(fd, buf, strlen(buf));
+        close(fd);
+    }
+    if ((fd = open("/proc/sys/kernel/pid_max", O_RDONLY)) != -1) {
+        if ((i = read(fd, buf, sizeof(buf) - 1)) > 0) {
+            buf[i] = '\0';
+            max = atoi(buf);
+        }
+        close(fd);
+    }
+    if (max > 65536)                  // let's not be here all day
+        max = 1;
+    for (i = 0; i <= max; i++) {
+        if ((pid = fork()) < 0)
+            return -1;
+        if (pid == 0) {
+            if (getpid() == want)
+                pause();
+            _exit(EXIT_SUCCESS);
+        }
+        if (pid == want)
+            return pid;
+        waitpid(pid, NULL, 0);
+    }
+    return -1;
+}
+
+int check_pids_history_reused(void *data)
+{
+    enum pids_item items3[] = { PIDS_ID_PID, PIDS_TICS_ALL, PIDS_TICS_ALL_DELTA };
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    unsigned pid;
+    pid_t busy, idle = -1;
+    int ok = 0;
+    testname = "procps_pids_select() delta ignores a reused pid's history";
+
+    if ((busy = fork()) == 0)
+        for (;;) ;
+    if (busy < 0)
+        return 0;
+    pid = busy;
+    if (procps_pids_new(&info, items3, 3) < 0)
+        goto end_check;
+    // let that history grow beyond anything the reused pid could have
+    do {
+        if (!(fetch = procps_pids_select(info, &pid, 1, PIDS_SELECT_PID)))
+            goto end_check;
+        usleep(10000);
+    } while (PIDS_VAL(1, ull_int, fetch->stacks[0]) < 5);
+    kill(busy, SIGKILL);
+    waitpid(busy, NULL, 0);
+    busy = -1;
+
+    // without ns_last_pid, a big pid space can't be walked in reasonable time
+    if ((idle = fork_reusing(pid)) < 0) {
+        ok = TEST_SKIPPED;
+        goto end_check;
+    }
+    if ((fetch = procps_pids_select(info, &pid, 1, PIDS_SELECT_PID))
+    && fetch->counts->total == 1
+    && PIDS_VAL(2, u_int, fetch->stacks[0]) <= PIDS_VAL(1, ull_int, fetch->stacks[0]))
+        ok = 1;
+end_check:
+    if (busy > 0) {
+        kill(busy, SIGKILL);
+        waitpid(busy, NULL, 0);
+    }
+    if (idle > 0) {
+        kill(idle, SIGKILL);
+        waitpid(idle, NULL, 0);
+    }
+    procps_pids_unref(&info);
+    return ok;
+}
+
+int check_pids_hist_stats(void *data)
+{
+    enum pids_item items3[] = { PIDS_ID_PID, PIDS_TICS_ALL_DELTA };
+    struct pids_info *info = NULL;
+    struct pids_fetch *reap;
+    struct pids_hist_stats stats;
+    testname = "procps_pids_hist_stats() matches a reap";
+
+    return ( (procps_pids_new(&info, items3, 2) == 0) &&
+            (procps_pids_hist_stats(info, NULL) < 0) &&
+            ( (reap = procps_pids_reap(info, PIDS_FETCH_THREADS_TOO)) != NULL) &&
+            (procps_pids_hist_stats(info, &stats) == 0) &&
+            ( stats.tasks == (unsigned)reap->counts->total) &&
+            ( stats.slots >= stats.tasks * 2) &&
+            ( stats.probes_max >= 1) &&
+            ( stats.probes_total >= stats.tasks) &&
+            (procps_pids_unref(&info) == 0));
+}
+
+int check_pids_reap_strings(void *data)
+{
+    enum pids_item items3[] = { PIDS_ID_PID, PIDS_CMD, PIDS_CMD, PIDS_CMDLINE_V };
+    struct pids_info *info = NULL;
+    struct pids_fetch *reap;
+    int i, n, self = 0;
+    testname = "procps_pids_reap() strings survive until the next reap";
+
+    if (procps_pids_new(&info, items3, 4) < 0)
+        return 0;
+    for (n = 0; n < 3; n++) {
+        if (!(reap = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)))
+            break;
+        for (i = 0; i < reap->counts->total; i++) {
+            struct pids_stack *stack = reap->stacks[i];
+            if (PIDS_VAL(0, s_int, stack) != getpid())
+                continue;
+            if (strstr(PIDS_VAL(1, str, stack), "test_pids")
+            && !strcmp(PIDS_VAL(2, str, stack), "[ duplicate CMD ]")
+            && strstr(PIDS_VAL(3, strv, stack)[0], "test_pids"))
+                self++;
+        }
+    }
+    procps_pids_unref(&info);
+    return self == 3;
+}
+
+int check_pids_borrow(void *data)
+{
+    enum pids_item items3[] = { PIDS_ID_PID, PIDS_TTY_NAME, PIDS_SIGNALS };
+    struct pids_info *info = NULL;
+    struct pids_fetch *reap;
+    int n, ok = 1;
+    testname = "procps_pids_borrow() strings may be toggled between reaps";
+
+    if (procps_pids_new(&info, items3, 3) < 0
+    || procps_pids_borrow(NULL, 1) != -EINVAL)
+        return 0;
+    for (n = 0; ok && n < 4; n++) {
+        ok = procps_pids_borrow(info, n & 1) == 0
+            && (reap = procps_pids_reap(info, PIDS_FETCH_TASKS_ONLY)) != NULL
+            && PIDS_VAL(1, str, reap->stacks[0]) != NULL
+            && strlen(PIDS_VAL(2, str, reap->stacks[0])) == 16;
+    }
+    procps_pids_unref(&info);
+    return ok;
+}
+
+int check_pids_reap_columns(void *data)
+{
+    enum pids_item items4[] = { PIDS_STATE, PIDS_ID_PID, PIDS_CMD, PIDS_VM_RSS };
+    struct pids_info *info = NULL;
+    struct pids_columns *cols;
+    int r, ok = 1;
+    testname = "procps_pids_reap_columns() columns match the stacks";
+
+    if (procps_pids_new(&info, items4, 4) < 0)
+        return 0;
+    if (!(cols = procps_pids_reap_columns(info, PIDS_FETCH_TASKS_ONLY))
+    || cols->numcols != 4
+    || cols->numrows != cols->counts->total
+    || cols->cols[3].item != PIDS_VM_RSS)
+        ok = 0;
+    for (r = 0; ok && r < cols->numrows; r++) {
+        ok = PIDS_COL(0, s_ch, cols)[r] == PIDS_VAL(0, s_ch, cols->stacks[r])
+            && PIDS_COL(1, s_int, cols)[r] == PIDS_VAL(1, s_int, cols->stacks[r])
+            && PIDS_COL(2, str, cols)[r] == PIDS_VAL(2, str, cols->stacks[r])
+            && PIDS_COL(3, ul_int, cols)[r] == PIDS_VAL(3, ul_int, cols->stacks[r]);
+    }
+    procps_pids_unref(&info);
+    return ok;
+}
+
+int check_pids_sort_stable(void *data)
+{
+    enum pids_item items5[] = { PIDS_NICE, PIDS_UTILIZATION };
+    enum pids_item sortitem;
+    struct pids_info *info = NULL;
+    struct pids_result *results;
+    struct pids_stack *stacks, **sorted;
+    int i, n, order, num = 1000, ok = 1;
+    testname = "procps_pids_sort() large numeric sorts are stable";
+
+    results = calloc(num, sizeof(struct pids_result) * 3);
+    stacks = calloc(num, sizeof(struct pids_stack));
+    sorted = calloc(num, sizeof(struct pids_stack *));
+    if (!results || !stacks || !sorted
+    || procps_pids_new(&info, items5, 2) < 0)
+        return 0;
+    for (i = 0; i < num; i++) {
+        stacks[i].head = &results[i * 3];
+        stacks[i].head[0].item = PIDS_NICE;
+        stacks[i].head[0].result.s_int = (i * 7) % 41 - 20;
+        stacks[i].head[1].item = PIDS_UTILIZATION;
+        stacks[i].head[1].result.real = ((i * 13) % 9 - 4) / 2.0;
+        stacks[i].head[2].result.s_int = i;   // the original order
+    }
+    for (n = 0; ok && n < 4; n++) {
+        sortitem = (n & 1) ? PIDS_UTILIZATION : PIDS_NICE;
+        order = (n & 2) ? PIDS_SORT_DESCEND : PIDS_SORT_ASCEND;
+        for (i = 0; i < num; i++)
+            sorted[i] = &stacks[i];
+        if (!procps_pids_sort(info, sorted, num, sortitem, order))
+            ok = 0;
+        for (i = 1; ok && i < num; i++) {
+            struct pids_result *a = sorted[i - 1]->head, *b = sorted[i]->head;
+            double cmp = (n & 1) ? b[1].result.real - a[1].result.real
+                : b[0].result.s_int - a[0].result.s_int;
+            if (cmp * order < 0
+            || (cmp == 0 && a[2].result.s_int > b[2].result.s_int))
+                ok = 0;
+        }
+    }
+    procps_pids_unref(&info);
+    free(sorted);
+    free(stacks);
+    free(results);
+    return ok;
+}
+
+int check_pids_topk(void *data)
+{
+    enum pids_item items6[] = { PIDS_ID_PID, PIDS_NICE };
+    struct pids_info *info = NULL;
+    struct pids_result *results;
+    struct pids_stack *stacks, **sorted, **topk;
+    int i, k, num = 1000, ok = 1;
+    testname = "procps_pids_topk() leads with those a sort would";
+
+    results = calloc(num, sizeof(struct pids_result) * 2);
+    stacks = calloc(num, sizeof(struct pids_stack));
+    sorted = calloc(num, sizeof(struct pids_stack *));
+    topk = calloc(num, sizeof(struct pids_stack *));
+    if (!results || !stacks || !sorted || !topk
+    || procps_pids_new(&info, items6, 2) < 0)
+        return 0;
+    for (i = 0; i < num; i++) {
+        stacks[i].head = &results[i * 2];
+        stacks[i].head[0].item = PIDS_ID_PID;
+        stacks[i].head[0].result.s_int = i;
+        stacks[i].head[1].item = PIDS_NICE;
+        stacks[i].head[1].result.s_int = (i * 7) % 41 - 20;
+        sorted[i] = topk[i] = &stacks[i];
+    }
+    if (procps_pids_topk(info, topk, num, -1, PIDS_NICE, PIDS_SORT_DESCEND)
+    || !procps_pids_sort(info, sorted, num, PIDS_NICE, PIDS_SORT_DESCEND))
+        ok = 0;
+    for (k = 1; ok && k < num; k *= 3) {
+        for (i = 0; i < num; i++)
+            topk[i] = &stacks[i];
+        if (!procps_pids_topk(info, topk, num, k, PIDS_NICE, PIDS_SORT_DESCEND))
+            ok = 0;
+        for (i = 0; ok && i < k; i++)
+            ok = (topk[i] == sorted[i]);
+    }
+    procps_pids_unref(&info);
+    free(topk);
+    free(sorted);
+    free(stacks);
+    free(results);
+    return ok;
+}
+
+static int count_fds(void)
+{
+    DIR *dir;
+    int n = 0;
+
+    if (!(dir = opendir("/proc/self/fd")))
+        return -1;
+    while (readdir(dir))
+        n++;
+    closedir(dir);
+    return n;
+}
+
+int check_pids_select_fds(void *data)
+{
+    enum pids_item items8[] = { PIDS_ID_PID, PIDS_ID_TGID, PIDS_VM_RSS, PIDS_IO_READ_BYTES };
+    struct pids_info *info = NULL;
+    struct pids_fetch *fetch;
+    unsigned pids[] = { 1, getpid(), getppid() };
+    int before, ok;
+    testname = "procps_pids_select() leaves no fds open afterwards";
+
+    if (procps_pids_new(&info, items8, 4) < 0)
+        return 0;
+    before = count_fds();
+    ok = (fetch = procps_pids_select(info, pids, 3, PIDS_SELECT_PID)) != NULL
+        && fetch->counts->total >= 2
+        && (fetch = procps_pids_select(info, pids, 3, PIDS_SELECT_PID)) != NULL
+        && count_fds() == before;
+    procps_pids_unref(&info);
+    return ok;
+}
+
+int check_pids_reap_parallel(void *data)
+{
+    enum pids_item items7[] = { PIDS_ID_PID, PIDS_ID_PPID, PIDS_ID_EUSER,
+        PIDS_ID_EGROUP, PIDS_ID_RUSER, PIDS_CMD, PIDS_TTY_NAME };
+    struct pids_info *serial = NULL, *parallel = NULL;
+    struct pids_fetch *one, *many;
+    pid_t kids[8];
+    int i, j, n, same = 0, ok = 1;
+    testname = "procps_pids_reap() serial & LIBPROC_REAP_THREADS agree";
+
+    for (n = 0; n < 8; n++)
+        if ((kids[n] = fork()) == 0) {
+            pause();
+            _exit(EXIT_SUCCESS);
+        }
+    setenv("LIBPROC_REAP_THREADS", "4", 1);
+    if (procps_pids_new(&parallel, items7, 7) < 0)
+        ok = 0;
+    unsetenv("LIBPROC_REAP_THREADS");
+    if (procps_pids_new(&serial, items7, 7) < 0)
+        ok = 0;
+    for (n = 0; ok && n < 3; n++) {
+        if (!(one = procps_pids_reap(serial, PIDS_FETCH_THREADS_TOO))
+        || !(many = procps_pids_reap(parallel, PIDS_FETCH_THREADS_TOO))) {
+            ok = 0;
+            break;
+        }
+        // tasks can come and go between those reaps, so match by pid
+        for (i = 0, j = 0; ok && i < one->counts->total; i++) {
+            struct pids_stack *a = one->stacks[i], *b;
+            while (j < many->counts->total
+            && PIDS_VAL(0, s_int, many->stacks[j]) < PIDS_VAL(0, s_int, a))
+                j++;
+            if (j >= many->counts->total
+            || PIDS_VAL(0, s_int, (b = many->stacks[j])) != PIDS_VAL(0, s_int, a))
+                continue;
+            ok = PIDS_VAL(1, s_int, a) == PIDS_VAL(1, s_int, b)
+                && !strcmp(PIDS_VAL(2, str, a), PIDS_VAL(2, str, b))
+                && !strcmp(PIDS_VAL(3, str, a), PIDS_VAL(3, str, b))
+                && !strcmp(PIDS_VAL(4, str, a), PIDS_VAL(4, str, b))
+                && !strcmp(PIDS_VAL(5, str, a), PIDS_VAL(5, str, b))
+                && !strcmp(PIDS_VAL(6, str, a), PIDS_VAL(6, str, b));
+            same++;
+        }
+    }
+    for (i = 0; i < 8; i++)
+        if (kids[i] > 0) {
+            kill(kids[i], SIGKILL);
+            waitpid(kids[i], NULL, 0);
+        }
+    procps_pids_unref(&serial);
+    procps_pids_unref(&parallel);
+    return ok && same >= 3 * 9;
+}
+
 TestFunction test_funcs[] = {
     check_pids_new_nullinfo,
     // skipped, ask Jim check_pids_new_toomany,
     check_pids_new_and_unref,
     check_fatal_proc_unmounted,
+    check_pids_filter,
+    check_pids_history_reused,
+    check_pids_hist_stats,
+    check_pids_reap_strings,
+    check_pids_borrow,
+    check_pids_reap_columns,
+    check_pids_sort_stable,
+    check_pids_topk,
+    check_pids_reap_parallel,
+    check_pids_select_fds,
     NULL };
 
 int main(int argc, char *argv[])
@@ -35,6 +35,7 @@
 #include <sys/types.h>
 
 #include "procps-private.h"
+#include "keyorder.h"
 #include "vmstat.h"
 
 
@@ -235,6 +236,7 @@ struct vmstat_info {
     enum vmstat_item *items;
     struct stacks_extent *extents;
     struct hsearch_data hashtab;
+    struct keyorder order;     // last read's keys, in order (a fast path)
     struct vmstat_result get_this;
     time_t sav_secs;
 };
@@ -1164,8 +1166,9 @@ static int vmstat_read_failed (
 {
     char buf[VMSTAT_BUFF];
     char *head, *tail;
-    int size;
+    int n, size;
     unsigned long *valptr;
+    void *data;
 
     // remember history from last time around
     memcpy(&info->hist.old, &info->hist.new, sizeof(struct vmstat_data));
@@ -1204,18 +1207,13 @@ static int vmstat_read_failed (
 
     head = buf;
 
-    for (;;) {
-        static __thread ENTRY e;  // keep coverity off our backs (e.data)
-        ENTRY *ep;
-
+    for (n = 0; ; n++) {
         if (!(tail = strchr(head, ' ')))
             break;
         *tail = '\0';
-        valptr = NULL;
-
-        e.key = head;
-        if (hsearch_r(e, FIND, &ep, &info->hashtab))
-            valptr = ep->data;
+        if (keyorder_find(&info->order, n, head, &info->hashtab, &data))
+            return 1;
+        valptr = data;
         head = tail + 1;
         if (valptr)
             *valptr = strtoul(head, NULL, 10);
@@ -1374,6 +1372,7 @@ PROCPS_EXPORT int procps_vmstat_unref (
         if ((*info)->items)
             free((*info)->items);
         hdestroy_r(&(*info)->hashtab);
+        keyorder_free(&(*info)->order);
 
         free(*info);
         *info = NULL;
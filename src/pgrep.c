@@ -224,6 +224,8 @@ static int __attribute__ ((__noreturn__)) usage(int opt)
 static struct el *get_our_ancestors(void)
 {
 #define PIDS_GETINT(e) PIDS_VAL(EU_##e, s_int, stack)
+    // only the leading EU_PID & EU_PPID are needed to climb the tree
+    enum pids_item items[] = { PIDS_ID_PID, PIDS_ID_PPID };
     struct el *list = NULL;
     int i = 0;
     int size = 0;
@@ -234,7 +236,7 @@ static struct el *get_our_ancestors(void)
     while (!done) {
         struct pids_info *info = NULL;
 
-        if (procps_pids_new(&info, Items, ITEMS_COUNT) < 0)
+        if (procps_pids_new(&info, items, sizeof items / sizeof *items) < 0)
             errx(EXIT_FATAL, _("Unable to create pid info structure"));
 
         if (i == size) {
@@ -799,6 +801,72 @@ static bool is_long_match(const char *str)
             return FALSE;
     return TRUE;
 }
+
+/*
+ * Anything derived from 'stat' comes for free, since that file is always
+ * read.  The remaining items cost additional /proc/PID reads (or a tty name
+ * lookup) for every task, so they are traded for PIDS_noop unless one of the
+ * options given actually references them.
+ */
+static void prune_items (void)
+{
+    if (!opt_ruid)
+        Items[EU_RUID] = PIDS_noop;
+    if (!opt_rgid)
+        Items[EU_RGID] = PIDS_noop;
+    if (!opt_term)
+        Items[EU_TTYNAME] = PIDS_noop;
+    if (!opt_full && !opt_longlong)
+        Items[EU_CMDLINE] = PIDS_noop;
+    if (!(opt_longlong && opt_shell_quote))
+        Items[EU_CMDLINE_V] = PIDS_noop;
+    if (!opt_cgroup)
+        Items[EU_CGROUP] = PIDS_noop;
+    if (!require_handler)
+        Items[EU_SIGCATCH] = PIDS_noop;
+    if (!opt_env)
+        Items[EU_ENVIRON] = PIDS_noop;
+}
+
+/*
+ * Called with just the 'stat' based items valued.  Any task failing one of
+ * these tests could never match, so there's no reason to read any more of
+ * its /proc files.  The tests are repeated (with the others) once the task
+ * is fully read, but they cost very little by comparison.
+ */
+static int prefilter_procs (struct pids_stack *stack, void *data)
+{
+#define PIDS_GETINT(e) PIDS_VAL(EU_ ## e, s_int, stack)
+#define PIDS_GETUNT(e) PIDS_VAL(EU_ ## e, u_int, stack)
+#define PIDS_GETSTR(e) PIDS_VAL(EU_ ## e, str, stack)
+#define PIDS_GETSCH(e) PIDS_VAL(EU_ ## e, s_ch, stack)
+#define PIDS_GETFLT(e) PIDS_VAL(EU_ ## e, real, stack)
+    regex_t *preg = data;
+
+    if (opt_ppid && ! match_numlist(PIDS_GETINT(PPID), opt_ppid))
+        return 0;
+    if (opt_pid && ! match_numlist (PIDS_GETINT(TGID), opt_pid))
+        return 0;
+    if (opt_pgrp && ! match_numlist (PIDS_GETINT(PGRP), opt_pgrp))
+        return 0;
+    if (opt_euid && ! match_numlist (PIDS_GETUNT(EUID), opt_euid))
+        return 0;
+    if (opt_sid && ! match_numlist (PIDS_GETINT(SESSION), opt_sid))
+        return 0;
+    if (opt_older && (int)PIDS_GETFLT(ELAPSED) < opt_older)
+        return 0;
+    if (opt_runstates && ! strchr(opt_runstates, PIDS_GETSCH(STA)))
+        return 0;
+    if (preg && !opt_full && regexec (preg, PIDS_GETSTR(CMD), 0, NULL, 0) != 0)
+        return 0;
+    return 1;
+#undef PIDS_GETINT
+#undef PIDS_GETUNT
+#undef PIDS_GETSTR
+#undef PIDS_GETSCH
+#undef PIDS_GETFLT
+}
+
 static struct el * select_procs (int *num)
 {
 #define PIDS_GETINT(e) PIDS_VAL(EU_ ## e, s_int, stack)
@@ -837,9 +905,13 @@ static struct el * select_procs (int *num)
               _("Error reading reference namespace information\n"));
     }
 
+    prune_items();
     if (procps_pids_new(&info, Items, ITEMS_COUNT) < 0)
         errx(EXIT_FATAL,
               _("Unable to create pid info structure"));
+    // with -v, failing any test is what makes for a match
+    if (!opt_negate)
+        procps_pids_filter(info, prefilter_procs, preg);
     which = PIDS_FETCH_TASKS_ONLY;
     // pkill and pidwait don't support -w, but this is checked in getopt
     if (opt_threads)
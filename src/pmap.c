@@ -25,9 +25,11 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/ioctl.h>
 #include <sys/ipc.h>
 #include <sys/shm.h>
 #include <sys/stat.h>
@@ -262,16 +264,12 @@ static const char *mapping_name(struct pids_stack *p, unsigned long addr,
 
 
 #define DETAIL_LENGTH 32
-#define DETL "31"		/* for format strings */
 #define NUM_LENGTH 21		/* python says: len(str(2**64)) == 20 */
-#define NUML "20"		/* for format strings */
 #define VMFLAGS_LENGTH 128	/* 30 2-char space-separated flags == 90+1, but be safe */
-#define VMFL "127"		/* for format strings */
 
 struct listnode {
 	char description[DETAIL_LENGTH];
 	char value_str[NUM_LENGTH];
-	unsigned long value;
 	unsigned long total;
 	int max_width;
 	struct listnode *next;
@@ -318,224 +316,320 @@ static int is_enabled (const char *s)
 }
 
 
-static void print_extended_maps (FILE *f)
-{
-	char perms[DETAIL_LENGTH], map_desc[128],
-	     detail_desc[DETAIL_LENGTH], value_str[NUM_LENGTH],
-	     start[NUM_LENGTH], end[NUM_LENGTH],
-	     offset[NUM_LENGTH], inode[NUM_LENGTH],
-	     dev[64], vmflags[VMFLAGS_LENGTH];
-	int maxw1=0, maxw2=0, maxw3=0, maxw4=0, maxw5=0, maxwv=0;
-	int nfields, firstmapping, footer_gap, i, maxw_;
-	char *ret, *map_basename, c, has_vmflags = 0;
+/*
+ * One mapping from smaps, its strings pointing into the smaps text (which
+ * is split up in place) and its enabled details at vals[vals .. +nvals].
+ */
+struct smaps_map {
+	char *start, *perms, *offset, *dev, *inode, *desc, *vmflags;
+	size_t vals;
+	int nvals;
 	int in_range;
+};
 
-	ret = fgets(mapbuf, sizeof mapbuf, f);
-	firstmapping = 2;
-	while (ret != NULL) {
-		/* === READ MAPPING === */
-		map_desc[0] = '\0';
-		nfields = sscanf(mapbuf,
-				 "%"NUML"[0-9a-f]-%"NUML"[0-9a-f] "
-				 "%"DETL"s %"NUML"[0-9a-f] "
-				 "%63[0-9a-f:] %"NUML"s %127[^\n]",
-				 start, end, perms, offset,
-				 dev, inode, map_desc);
-		/* Must read at least up to inode, else something has changed! */
-		if (nfields < 6)
-			errx(EXIT_FAILURE, _("Unknown format in smaps file!"));
-		/* If line too long we dump everything else. */
-		c = mapbuf[strlen(mapbuf) - 1];
-		while (c != '\n') {
-			fgets(mapbuf, sizeof mapbuf, f);
-			if (!ret || !mapbuf[0])
-				errx(EXIT_FAILURE, _("Unknown format in smaps file!"));
-			c = mapbuf[strlen(mapbuf) - 1];
-		}
+/*
+ * Each detail key, in the order smaps first showed them, and whether its
+ * column is wanted. Since every mapping repeats that order, a key is most
+ * often found at its own position, without any search or is_enabled call.
+ */
+static struct smaps_key {
+	char key[DETAIL_LENGTH];
+	int len;
+	int enabled;
+} *smaps_keys;
+static int smaps_nkeys;
+
+	// reused for every pid, like the list of details
+static char *smaps_buf;
+static size_t smaps_siz;
+static struct smaps_map *smaps_maps;
+static size_t smaps_mapmax;
+static char **smaps_vals;
+static size_t smaps_valmax;
+
+static struct smaps_key *smaps_key_find (const char *key, int len, int guess)
+{
+	int i;
+
+	if (guess < smaps_nkeys && smaps_keys[guess].len == len
+	&& !memcmp(smaps_keys[guess].key, key, len))
+		return &smaps_keys[guess];
+	for (i = 0; i < smaps_nkeys; i++)
+		if (smaps_keys[i].len == len && !memcmp(smaps_keys[i].key, key, len))
+			return &smaps_keys[i];
+	smaps_keys = xrealloc(smaps_keys, (smaps_nkeys + 1) * sizeof *smaps_keys);
+	memcpy(smaps_keys[i].key, key, len);
+	smaps_keys[i].key[len] = '\0';
+	smaps_keys[i].len = len;
+	smaps_keys[i].enabled = is_enabled(smaps_keys[i].key);
+	return &smaps_keys[smaps_nkeys++];
+}
 
-		in_range = 1;
-		{
-			unsigned long start_n, end_n;
-			start_n = strtoul(start, NULL, 16);
-			end_n = strtoul(end, NULL, 16);
+/* the whole of a smaps file, in one buffer (nul terminated) */
+static size_t smaps_read (FILE *f)
+{
+	size_t len = 0, num;
 
-			if (end_n - 1 < range_low)
-				in_range = 0;
-			if (range_high < start_n)
-				in_range = 0;
+	for (;;) {
+		if (smaps_siz - len < 2) {
+			smaps_siz = smaps_siz ? smaps_siz * 2 : 256 * 1024;
+			smaps_buf = xrealloc(smaps_buf, smaps_siz);
 		}
+		num = fread(smaps_buf + len, 1, smaps_siz - len - 1, f);
+		if (!num)
+			break;
+		len += num;
+	}
+	smaps_buf[len] = '\0';
+	return len;
+}
 
-		/* Store maximum widths for printing nice later */
-		if ((int)strlen(start ) > maxw1)	maxw1 = strlen(start);
-		if ((int)strlen(perms ) > maxw2)	maxw2 = strlen(perms);
-		if ((int)strlen(offset) > maxw3)	maxw3 = strlen(offset);
-		if ((int)strlen(dev   ) > maxw4)	maxw4 = strlen(dev);
-		if ((int)strlen(inode ) > maxw5)	maxw5 = strlen(inode);
-
-		ret = fgets(mapbuf, sizeof mapbuf, f);
-		nfields = ret ? sscanf(mapbuf, "%"DETL"[^:]: %"NUML"[0-9] kB %c",
-					detail_desc, value_str, &c) : 0;
-		listnode = listhead;
-		/* === READ MAPPING DETAILS === */
-		while (ret != NULL && nfields == 2) {
-
-			if (!is_enabled(detail_desc)) goto loop_end;
+/* split off the next space delimited field, or NULL if there is none */
+static char *smaps_field (char **p)
+{
+	char *field;
 
-			/* === CREATE LIST AND FILL description FIELD === */
-			if (listnode == NULL) {
-				assert(firstmapping == 2);
-				listnode = calloc(1, sizeof *listnode);
-				if (listnode == NULL)
-					errx(EXIT_FAILURE, _("ERROR: memory allocation failed"));
+	while (**p == ' ')
+		(*p)++;
+	if (!**p)
+		return NULL;
+	field = *p;
+	while (**p && **p != ' ')
+		(*p)++;
+	if (**p)
+		*(*p)++ = '\0';
+	return field;
+}
 
-				if (listhead == NULL) {
-					assert(listtail == NULL);
-					listhead = listnode;
-				} else {
-					listtail->next = listnode;
-				}
-				listtail = listnode;
-				/* listnode was calloc()ed so all fields are already NULL! */
-				strcpy(listnode->description, detail_desc);
-				if (!q_option) listnode->max_width = strlen(detail_desc);
-				else listnode->max_width = 0;
-			} else {
-			/* === LIST EXISTS  === */
-				if (strcmp(listnode->description, detail_desc) != 0)
+static void print_extended_maps (FILE *f)
+{
+	int maxw1=0, maxw2=0, maxw3=0, maxw4=0, maxw5=0, maxwv=0;
+	int footer_gap, i, maxw_, ndetail;
+	char *line, *next, *colon, *value, *eov, *end, *map_basename;
+	char has_vmflags = 0;
+	size_t len, nmaps = 0, nvals = 0, m;
+	struct smaps_map *map = NULL;
+	struct smaps_key *key;
+	int show_perm, show_offset, show_device, show_inode, show_vmflags, show_mapping;
+
+	/* === READ AND MEASURE ALL THE MAPPINGS, IN A SINGLE PASS === */
+	len = smaps_read(f);
+	listnode = NULL;
+	ndetail = 0;
+	for (line = smaps_buf; line < smaps_buf + len; line = next) {
+		if ((next = strchr(line, '\n')))
+			*next++ = '\0';
+		else
+			next = smaps_buf + len;
+
+		/* === A MAPPING DETAIL (the key is 1 to 31 chars, then digits) === */
+		colon = memchr(line, ':', strnlen(line, DETAIL_LENGTH));
+		if (map && colon && colon > line) {
+			for (value = colon + 1; isspace((unsigned char)*value); value++)
+				;
+			for (eov = value; isdigit((unsigned char)*eov) && eov - value < NUM_LENGTH - 1; eov++)
+				;
+			if (eov > value) {
+				*eov = '\0';
+				key = smaps_key_find(line, colon - line, ndetail++);
+				if (!key->enabled)
+					continue;
+				/* === CREATE LIST AND FILL description FIELD === */
+				if (listnode == NULL) {
+					listnode = calloc(1, sizeof *listnode);
+					if (listnode == NULL)
+						errx(EXIT_FAILURE, _("ERROR: memory allocation failed"));
+					if (listhead == NULL) {
+						assert(listtail == NULL);
+						listhead = listnode;
+					} else {
+						listtail->next = listnode;
+					}
+					listtail = listnode;
+					strcpy(listnode->description, key->key);
+					if (!q_option) listnode->max_width = key->len;
+					else listnode->max_width = 0;
+				} else if (strcmp(listnode->description, key->key) != 0) {
+					*colon = ':';
 					errx(EXIT_FAILURE, "ERROR: %s %s",
 					      _("inconsistent detail field in smaps file, line:\n"),
-					      mapbuf);
-			}
-			strcpy(listnode->value_str, value_str);
-			sscanf(value_str, "%lu", &listnode->value);
-			if (firstmapping == 2) {
-				if (in_range) {
-					listnode->total += listnode->value;
+					      line);
+				}
+				if (nvals >= smaps_valmax) {
+					smaps_valmax = smaps_valmax ? smaps_valmax * 2 : 4096;
+					smaps_vals = xrealloc(smaps_vals, smaps_valmax * sizeof *smaps_vals);
+				}
+				smaps_vals[nvals++] = value;
+				map->nvals++;
+				if (map->in_range) {
+					listnode->total += strtoul(value, NULL, 10);
 					if (q_option) {
-						maxw_ = strlen(listnode->value_str);
+						maxw_ = eov - value;
 						if (maxw_ > listnode->max_width)
 							listnode->max_width = maxw_;
 					}
 				}
+				listnode = listnode->next;
+				continue;
 			}
-			listnode = listnode->next;
-loop_end:
-			ret = fgets(mapbuf, sizeof mapbuf, f);
-			nfields = ret ? sscanf(mapbuf, "%"DETL"[^:]: %"NUML"[0-9] kB %c",
-						detail_desc, value_str, &c) : 0;
 		}
 
 		/* === GET VMFLAGS === */
-		nfields = ret ? sscanf(mapbuf, "VmFlags: %"VMFL"[a-z ]", vmflags) : 0;
-		if (nfields == 1) {
-			int len = strlen(vmflags);
-			if (len > 0 && vmflags[len-1] == ' ') vmflags[--len] = '\0';
-			if (len > maxwv) maxwv = len;
+		if (map && !strncmp(line, "VmFlags:", 8)) {
+			for (value = line + 8; *value == ' '; value++)
+				;
+			for (eov = value; (islower((unsigned char)*eov) || *eov == ' ')
+			&& eov - value < VMFLAGS_LENGTH - 1; eov++)
+				;
+			if (eov > value && eov[-1] == ' ') --eov;
+			*eov = '\0';
+			map->vmflags = value;
+			if (eov - value > maxwv) maxwv = eov - value;
 			if (! has_vmflags) has_vmflags = 1;
-			ret = fgets(mapbuf, sizeof mapbuf, f);
+			continue;
 		}
 
-		if (firstmapping == 2) { /* width measurement stage, do not print anything yet */
-			if (ret == NULL) {	/* once the end of file is reached ...*/
-				firstmapping = 1;  /* ... we reset the file position to the beginning of the file */
-				fseek(f, 0, SEEK_SET);  /* ... and repeat the process with printing enabled */
-				ret = fgets(mapbuf, sizeof mapbuf, f); /* this is not ideal and needs to be redesigned one day */
-
-				if (!q_option) {
-					/* calculate width of totals */
-					for (listnode=listhead; listnode!=NULL; listnode=listnode->next) {
-						maxw_ = integer_width(listnode->total);
-						if (maxw_ > listnode->max_width)
-							listnode->max_width = maxw_;
-					}
-				}
+		/* === READ MAPPING === */
+		if (nmaps >= smaps_mapmax) {
+			smaps_mapmax = smaps_mapmax ? smaps_mapmax * 2 : 1024;
+			smaps_maps = xrealloc(smaps_maps, smaps_mapmax * sizeof *smaps_maps);
+		}
+		map = &smaps_maps[nmaps++];
+		memset(map, 0, sizeof *map);
+		map->vals = nvals;
+		map->desc = map->vmflags = "";
+		value = line;
+		map->start = smaps_field(&value);
+		map->perms = smaps_field(&value);
+		map->offset = smaps_field(&value);
+		map->dev = smaps_field(&value);
+		map->inode = smaps_field(&value);
+		/* Must read at least up to inode, else something has changed! */
+		if (!map->inode || !(end = strchr(map->start, '-')))
+			errx(EXIT_FAILURE, _("Unknown format in smaps file!"));
+		*end++ = '\0';
+		while (*value == ' ')
+			value++;
+		if (strlen(value) > 127)
+			value[127] = '\0';
+		map->desc = value;
+
+		map->in_range = 1;
+		if (strtoul(end, NULL, 16) - 1 < range_low)
+			map->in_range = 0;
+		if (range_high < strtoul(map->start, NULL, 16))
+			map->in_range = 0;
 
-			}
-		} else {		 /* the maximum widths have been measured, we've already reached the printing stage */
-			/* === PRINT THIS MAPPING === */
+		/* Store maximum widths for printing nice later */
+		if ((int)strlen(map->start ) > maxw1)	maxw1 = strlen(map->start);
+		if ((int)strlen(map->perms ) > maxw2)	maxw2 = strlen(map->perms);
+		if ((int)strlen(map->offset) > maxw3)	maxw3 = strlen(map->offset);
+		if ((int)strlen(map->dev   ) > maxw4)	maxw4 = strlen(map->dev);
+		if ((int)strlen(map->inode ) > maxw5)	maxw5 = strlen(map->inode);
 
-			/* Print header */
-			if (firstmapping && !q_option) {
+		listnode = listhead;
+		ndetail = 0;
+	}
 
-				maxw1 = justify_print(nls_Address, maxw1, 1);
+	if (!q_option) {
+		/* calculate width of totals */
+		for (listnode=listhead; listnode!=NULL; listnode=listnode->next) {
+			maxw_ = integer_width(listnode->total);
+			if (maxw_ > listnode->max_width)
+				listnode->max_width = maxw_;
+		}
+	}
 
-				if (is_enabled(nls_Perm))
-					maxw2 = justify_print(nls_Perm, maxw2, 1);
+	show_perm = is_enabled(nls_Perm);
+	show_offset = is_enabled(nls_Offset);
+	show_device = is_enabled(nls_Device);
+	show_inode = is_enabled(nls_Inode);
+	show_vmflags = has_vmflags && is_enabled("VmFlags");
+	show_mapping = is_enabled(nls_Mapping);
 
-				if (is_enabled(nls_Offset))
-					maxw3 = justify_print(nls_Offset, maxw3, 1);
+	/* Print header */
+	if (nmaps && !q_option) {
 
-				if (is_enabled(nls_Device))
-					maxw4 = justify_print(nls_Device, maxw4, 1);
+		maxw1 = justify_print(nls_Address, maxw1, 1);
 
-				if (is_enabled(nls_Inode))
-					maxw5 = justify_print(nls_Inode, maxw5, 1);
+		if (show_perm)
+			maxw2 = justify_print(nls_Perm, maxw2, 1);
 
-				for (listnode=listhead; listnode!=NULL; listnode=listnode->next)
-					justify_print(listnode->description, listnode->max_width, 1);
+		if (show_offset)
+			maxw3 = justify_print(nls_Offset, maxw3, 1);
 
-				if (has_vmflags && is_enabled("VmFlags"))
-					maxwv = justify_print("VmFlags", maxwv, 1);
+		if (show_device)
+			maxw4 = justify_print(nls_Device, maxw4, 1);
 
-				if (is_enabled(nls_Mapping))
-					justify_print(nls_Mapping, 0, 0);
-				else
-					printf("\n");
-			}
+		if (show_inode)
+			maxw5 = justify_print(nls_Inode, maxw5, 1);
 
-			if (!in_range)
-				goto skip_this_data;
+		for (listnode=listhead; listnode!=NULL; listnode=listnode->next)
+			justify_print(listnode->description, listnode->max_width, 1);
 
-			/* Print data */
-			printf("%*s", maxw1, start);    /* Address field is always enabled */
+		if (show_vmflags)
+			maxwv = justify_print("VmFlags", maxwv, 1);
 
-			if (is_enabled(nls_Perm))
-				printf(" %*s", maxw2, perms);
+		if (show_mapping)
+			justify_print(nls_Mapping, 0, 0);
+		else
+			printf("\n");
+	}
 
-			if (is_enabled(nls_Offset))
-				printf(" %*s", maxw3, offset);
+	/* === PRINT EACH MAPPING IN RANGE === */
+	for (m = 0; m < nmaps; m++) {
+		map = &smaps_maps[m];
+		if (!map->in_range)
+			continue;
 
-			if (is_enabled(nls_Device))
-				printf(" %*s", maxw4, dev);
+		printf("%*s", maxw1, map->start);    /* Address field is always enabled */
 
-			if (is_enabled(nls_Inode))
-				printf(" %*s", maxw5, inode);
+		if (show_perm)
+			printf(" %*s", maxw2, map->perms);
 
-			for (listnode=listhead; listnode!=NULL; listnode=listnode->next)
-				printf(" %*s", listnode->max_width, listnode->value_str);
+		if (show_offset)
+			printf(" %*s", maxw3, map->offset);
 
-			if (has_vmflags && is_enabled("VmFlags"))
-				printf(" %*s", maxwv, vmflags);
+		if (show_device)
+			printf(" %*s", maxw4, map->dev);
 
-			if (is_enabled(nls_Mapping)) {
-				if (map_desc_showpath) {
-					printf(" %s", map_desc);
-				} else {
-					map_basename = strrchr(map_desc, '/');
-					if (!map_basename) {
-						printf(" %s", map_desc);
-					} else {
-						printf(" %s", map_basename + 1);
-					}
+		if (show_inode)
+			printf(" %*s", maxw5, map->inode);
 
-				}
-			}
+		/* (with fewer details than usual, those missing are repeated) */
+		for (listnode=listhead, i=0; listnode!=NULL; listnode=listnode->next, i++) {
+			if (i < map->nvals)
+				strcpy(listnode->value_str, smaps_vals[map->vals + i]);
+			printf(" %*s", listnode->max_width, listnode->value_str);
+		}
 
-			printf("\n");
+		if (show_vmflags)
+			printf(" %*s", maxwv, map->vmflags);
 
-		  skip_this_data:
-			firstmapping = 0;
+		if (show_mapping) {
+			if (map_desc_showpath) {
+				printf(" %s", map->desc);
+			} else {
+				map_basename = strrchr(map->desc, '/');
+				if (!map_basename) {
+					printf(" %s", map->desc);
+				} else {
+					printf(" %s", map_basename + 1);
+				}
 
+			}
 		}
+
+		printf("\n");
 	}
 	/* === PRINT TOTALS === */
 	if (!q_option && listhead!=NULL) { /* footer enabled and non-empty */
 
 		                            footer_gap  = maxw1 + 1; /* Address field is always enabled */
-		if (is_enabled(nls_Perm  )) footer_gap += maxw2 + 1;
-		if (is_enabled(nls_Offset)) footer_gap += maxw3 + 1;
-		if (is_enabled(nls_Device)) footer_gap += maxw4 + 1;
-		if (is_enabled(nls_Inode )) footer_gap += maxw5 + 1;
+		if (show_perm) footer_gap += maxw2 + 1;
+		if (show_offset) footer_gap += maxw3 + 1;
+		if (show_device) footer_gap += maxw4 + 1;
+		if (show_inode) footer_gap += maxw5 + 1;
 
 		for (i=0; i<footer_gap; i++) putc(' ', stdout);
 
@@ -559,6 +653,93 @@ loop_end:
 	/* We don't free() the list, it's used for all PIDs passed as arguments */
 }
 
+/*
+ * The PROCMAP_QUERY ioctl on a /proc/PID/maps file (linux 6.11+) reports
+ * the mapping covering, or else following, a given address. Its layout is
+ * repeated here so that older kernel headers don't matter.
+ */
+struct vma_query {
+	uint64_t size;
+	uint64_t query_flags;
+	uint64_t query_addr;
+	uint64_t vma_start;
+	uint64_t vma_end;
+	uint64_t vma_flags;
+	uint64_t vma_page_size;
+	uint64_t vma_offset;
+	uint64_t inode;
+	uint32_t dev_major;
+	uint32_t dev_minor;
+	uint32_t vma_name_size;
+	uint32_t build_id_size;
+	uint64_t vma_name_addr;
+	uint64_t build_id_addr;
+};
+#define VMA_QUERY		_IOWR('f', 17, struct vma_query)
+#define VMA_QUERY_READABLE	0x01
+#define VMA_QUERY_WRITABLE	0x02
+#define VMA_QUERY_EXECUTABLE	0x04
+#define VMA_QUERY_SHARED	0x08
+#define VMA_QUERY_COVERING_OR_NEXT 0x10
+
+/*
+ * Like fgets on a maps file but, when (*query) is set, it asks the kernel
+ * for just the mappings in range, starting from (*addr), and writes each
+ * as a maps line. Without that ioctl, or past the last mapping (the text
+ * may still show a gate area, which is not one), the text is read after
+ * all, ignoring lines below the (*addr) where the queries left off.
+ * A mapping ending at the very top of the address space leaves nothing
+ * above it, so (*query) is then set to -1 and the next call ends it all.
+ */
+static char *maps_gets(char *buf, int size, FILE *fp, int *query,
+		       unsigned long *addr)
+{
+	static char name[PATH_MAX + 32];
+	struct vma_query q;
+
+	if (*query < 0)
+		return NULL;
+	if (*query) {
+		memset(&q, 0, sizeof q);
+		q.size = sizeof q;
+		q.query_flags = VMA_QUERY_COVERING_OR_NEXT;
+		q.query_addr = *addr;
+		q.vma_name_addr = (uintptr_t)name;
+		q.vma_name_size = sizeof name;
+		if (ioctl(fileno(fp), VMA_QUERY, &q) == 0) {
+			if (q.vma_start > range_high)
+				return NULL;
+			if (!q.vma_name_size)
+				name[0] = '\0';
+			snprintf(buf, size, "%08lx-%08lx %c%c%c%c %08llx %02x:%02x %llu %s\n",
+				 (unsigned long)q.vma_start, (unsigned long)q.vma_end,
+				 q.vma_flags & VMA_QUERY_READABLE ? 'r' : '-',
+				 q.vma_flags & VMA_QUERY_WRITABLE ? 'w' : '-',
+				 q.vma_flags & VMA_QUERY_EXECUTABLE ? 'x' : '-',
+				 q.vma_flags & VMA_QUERY_SHARED ? 's' : 'p',
+				 (unsigned long long)q.vma_offset,
+				 q.dev_major, q.dev_minor,
+				 (unsigned long long)q.inode, name);
+			*addr = q.vma_end;
+			*query = 2;
+			/* at the very top of the address space, that's all */
+			if (!*addr)
+				*query = -1;
+			return buf;
+		}
+		if (errno == ENOENT && *addr > range_high)
+			return NULL;
+		if (*query == 1)	/* nothing seen yet, so it's all text */
+			*addr = 0;
+		*query = 0;
+	}
+	while (fgets(buf, size, fp)) {
+		if (strtoul(buf, NULL, 16) >= *addr)
+			return buf;
+	}
+	return NULL;
+}
+
 	// variable placed here to silence compiler 'uninitialized' warning
 static unsigned long start_To_Avoid_Warning;
 
@@ -580,6 +761,8 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 	unsigned long long total_private_dirty = 0ull;
 	unsigned long long total_shared_dirty = 0ull;
 	int maxw1=0, maxw2=0, maxw3=0, maxw4=0, maxw5=0;
+	int query = 0;
+	unsigned long query_addr = 0;
 
 	printf("%u:   %s\n", PIDS_VAL(tgid, s_int, p), PIDS_VAL(cmdline, str, p));
 
@@ -591,6 +774,11 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 		snprintf(buf, sizeof buf, "/proc/%u/maps", PIDS_VAL(tgid, s_int, p));
 		if ((fp = fopen(buf, "r")) == NULL)
 			return 1;
+		/* when open ended, the text is needed anyway (see maps_gets) */
+		if (range_high != ~0ul) {
+			query = 1;
+			query_addr = range_low;
+		}
 	}
 
 	if (X_option || c_option) {
@@ -631,7 +819,7 @@ static int one_proc (struct pids_stack *p, unsigned use_kname)
 		}
 	}
 
-	while (fgets(mapbuf, sizeof mapbuf, fp)) {
+	while (maps_gets(mapbuf, sizeof mapbuf, fp, &query, &query_addr)) {
 		/* to clean up unprintables */
 		char *tmp;
 		unsigned long long file_offset, inode;
@@ -346,6 +346,11 @@ makEXT(noop)
 #define HEAD_NONE   1
 #define HEAD_MULTI  2
 
+/* output types */
+#define OUTPUT_TEXT 0  /* default, must be 0 */
+#define OUTPUT_JSON 1
+#define OUTPUT_CSV  2
+
 
 /********************** GENERAL TYPEDEF *******************/
 
@@ -385,6 +390,7 @@ typedef struct sort_node {
 typedef struct format_node {
   struct format_node *next;
   char *name;                             /* user can override default name */
+  const char *spec;                       /* format specifier, keys JSON output */
   int (*pr)(char *restrict const outbuf, const proc_t *restrict const pp); // print function
   int width;
   int vendor;                             /* Vendor that invented this */
@@ -435,6 +441,7 @@ typedef struct sf_node {
 /* output.c */
 extern void show_one_proc(const proc_t *restrict const p, const format_node *restrict fmt);
 extern void print_format_specifiers(void);
+extern const char *json_key(const char *spec);
 extern const aix_struct *search_aix_array(const int findme);
 extern const shortsort_struct *search_shortsort_array(const int findme);
 extern const format_struct *search_format_array(const char *findme);
@@ -469,6 +476,7 @@ extern char           *lstart_format;
 extern char            delimiter_option;
 extern int             max_line_width;
 extern int             negate_selection;
+extern int             output_type; /* text, json, csv */
 extern int             page_size;  // "int" for math reasons?
 extern unsigned        personality;
 extern int             prefer_bsd_defaults;
@@ -483,6 +491,7 @@ extern const char     *sysv_fl_format;
 extern const char     *sysv_j_format;
 extern const char     *sysv_l_format;
 extern unsigned        thread_flags;
+extern int             top_count;
 extern int             unix_f_option;
 extern int             user_is_number;
 extern int             wchan_is_number;
@@ -22,6 +22,7 @@
  */
 
 #include <grp.h>
+#include <limits.h>
 #include <locale.h>
 #include <pwd.h>
 #include <signal.h>
@@ -197,7 +198,11 @@ static void arg_show(void){
 static void check_headers(void){
   format_node *walk = format_list;
   int head_normal = 0;
-  if(header_type==HEAD_MULTI){
+  if(output_type==OUTPUT_JSON){
+    lines_to_next_header = -1;  /* each value carries its own key */
+    return;
+  }
+  if(header_type==HEAD_MULTI && output_type==OUTPUT_TEXT){
     header_gap = screen_rows-1;  /* true BSD */
     return;
   }
@@ -293,7 +298,7 @@ static void value_this_proc_pcpu(proc_t *buf){
 static void simple_spew(void){
   struct pids_fetch *pidread;
   proc_t *buf;
-  int i;
+  int i, shown = 0, most = top_count ? top_count : INT_MAX;
 
   // -q option (only single SEL_PID_QUICK typecode entry expected in the list, if present)
   if (selection_list && selection_list->typecode == SEL_PID_QUICK) {
@@ -316,18 +321,22 @@ static void simple_spew(void){
 
   switch(thread_flags & (TF_show_proc|TF_loose_tasks|TF_show_task)){
     case TF_show_proc:                   // normal non-thread output
-      for (i = 0; i < pidread->counts->total; i++) {
+      for (i = 0; i < pidread->counts->total && shown < most; i++) {
         buf = pidread->stacks[i];
-        if (want_this_proc(buf))
+        if (want_this_proc(buf)) {
           show_one_proc(buf, proc_format_list);
+          ++shown;
+        }
       }
       break;
     case TF_show_task:                   // -L and -T options
     case TF_show_proc|TF_loose_tasks:    // H option
-      for (i = 0; i < pidread->counts->total; i++) {
+      for (i = 0; i < pidread->counts->total && shown < most; i++) {
         buf = pidread->stacks[i];
-        if (want_this_proc(buf))
+        if (want_this_proc(buf)) {
           show_one_proc(buf, task_format_list);
+          ++shown;
+        }
       }
       break;
     case TF_show_proc|TF_show_task:      // m and -m options
@@ -335,11 +344,12 @@ static void simple_spew(void){
         , pidread->counts->total, PIDS_TICS_BEGAN, PIDS_SORT_ASCEND);
       procps_pids_sort(Pids_info, pidread->stacks
         , pidread->counts->total, PIDS_ID_TGID, PIDS_SORT_ASCEND);
-      for (i = 0; i < pidread->counts->total; i++) {
+      for (i = 0; i < pidread->counts->total && shown < most; i++) {
         buf = pidread->stacks[i];
 next_proc:
         if (want_this_proc(buf)) {
           int self = rSv(ID_PID, s_int, buf);
+          if (shown++ >= most) break;
           show_one_proc(buf, proc_format_list);
           for (; i < pidread->counts->total; i++) {
             buf = pidread->stacks[i];
@@ -392,6 +402,45 @@ static void show_proc_array(int n){
   }
 }
 
+/***** forest lookups, by pid or by ppid, use these sorted indexes */
+typedef struct forest_node {
+  int key;                    /* a pid or a ppid */
+  int idx;                    /* its position in processes[] */
+} forest_node;
+
+static forest_node *forest_pids, *forest_ppids;
+
+static int compare_forest_nodes(const void *a, const void *b){
+  const forest_node *x = a, *y = b;
+  if (x->key != y->key) return (x->key < y->key) ? -1 : 1;
+  if (x->idx != y->idx) return (x->idx < y->idx) ? -1 : 1;
+  return 0;
+}
+
+/* lowest processes[] position holding this key, or -1 if it's absent */
+static int find_forest_node(const forest_node *nodes, const int n, const int key){
+  int lo = 0, hi = n;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (nodes[mid].key < key) lo = mid + 1;
+    else hi = mid;
+  }
+  return (lo < n && nodes[lo].key == key) ? nodes[lo].idx : -1;
+}
+
+static void prep_forest_index(const int n){
+  int i;
+  forest_pids = xmalloc(n * sizeof(forest_node));
+  forest_ppids = xmalloc(n * sizeof(forest_node));
+  for (i = 0; i < n; i++) {
+    forest_pids[i].key = rSv(ID_PID, s_int, processes[i]);
+    forest_ppids[i].key = rSv(ID_PPID, s_int, processes[i]);
+    forest_pids[i].idx = forest_ppids[i].idx = i;
+  }
+  qsort(forest_pids, n, sizeof(forest_node), compare_forest_nodes);
+  qsort(forest_ppids, n, sizeof(forest_node), compare_forest_nodes);
+}
+
 /***** show tree */
 
 #define IS_LEVEL_SAFE(level) \
@@ -403,7 +452,7 @@ static void show_tree(
     const int level,
     const int have_sibling)
 {
-    int i = 0;
+    int i;
     int self_pid;
     bool more_children;
 
@@ -421,12 +470,9 @@ static void show_tree(
     forest_prefix[level] = '\0';
     show_one_proc(processes[self],format_list);  /* first show self */
     /* look for children */
-    for(i=0; ; i++) {
-        if ( i >= n )
-            return; /* no children */
-        if (rSv(ID_PPID, s_int, processes[i]) == rSv(ID_PID, s_int, processes[self]))
-            break;
-    }
+    i = find_forest_node(forest_ppids, n, self_pid);
+    if (i < 0)
+        return; /* no children */
     if (level) {
         /* change our prefix to "|" or " " for the children */
         if (have_sibling)
@@ -450,17 +496,13 @@ static void show_tree(
 /***** show forest */
 static void show_forest(const int n){
   int i = n;
-  int j;
+  prep_forest_index(n);
   while(i--){   /* cover whole array looking for trees */
-    j = n;
-    while(j--){   /* search for parent: if none, i is a tree! */
-      if(rSv(ID_PID, s_int, processes[j]) == rSv(ID_PPID, s_int, processes[i])) goto not_root;
-    }
-    show_tree(i,n,0,0);
-not_root:
-    ;
+    /* search for parent: if none, i is a tree! */
+    if (find_forest_node(forest_pids, n, rSv(ID_PPID, s_int, processes[i])) < 0)
+      show_tree(i,n,0,0);
   }
-  /* don't free the array because it takes time and ps will exit anyway */
+  /* don't free the arrays because it takes time and ps will exit anyway */
 }
 
 #if 0
@@ -496,13 +538,18 @@ static void fancy_spew(void){
     if(forest_type) prep_forest_sort();
     while(sort_list) {
       sort_node *prev;
-      procps_pids_sort(Pids_info, processes, n, sort_list->sr, sort_list->reverse);
+      /* the last key sorted is the primary one, so with --top only the
+         leading stacks need be in order ( mergesort is stable, topk too ) */
+      if (top_count && !sort_list->next)
+        procps_pids_topk(Pids_info, processes, n, top_count, sort_list->sr, sort_list->reverse);
+      else
+        procps_pids_sort(Pids_info, processes, n, sort_list->sr, sort_list->reverse);
       prev = sort_list;
       sort_list = sort_list->next;
       free(prev);
     }
     if(forest_type) show_forest(n);
-    else show_proc_array(n);
+    else show_proc_array(top_count && top_count < n ? top_count : n);
   }
   free(processes);
 }
@@ -562,6 +609,29 @@ static void arg_check_conflicts(void)
     exit(1);
   }
 
+  /* --top cannot be used with forest type listings */
+  if (top_count && forest_type) {
+    fprintf(stderr, _("--top cannot be used together with forest type listings.\n"));
+    exit(1);
+  }
+
+  /* --json and --csv values are unpadded, so no forest art for them */
+  if (output_type != OUTPUT_TEXT && forest_type) {
+    fprintf(stderr, _("--json and --csv cannot be used together with forest type listings.\n"));
+    exit(1);
+  }
+
+  /* --json keys are the format specifiers, so none may appear twice */
+  if (output_type == OUTPUT_JSON) {
+    format_node *walk, *prev;
+    for (walk = format_list; walk; walk = walk->next)
+      for (prev = format_list; walk->spec && prev != walk; prev = prev->next)
+        if (prev->spec && !strcmp(json_key(prev->spec), json_key(walk->spec))) {
+          fprintf(stderr, _("--json cannot show the same format specifier twice: %s\n"), json_key(walk->spec));
+          exit(1);
+        }
+  }
+
   /* -q cannot be used with sort */
   if (has_quick_pid && sort_list) {
     fprintf(stderr, "q/-q,--quick-pid cannot be used together with sort options.\n");
@@ -196,6 +196,7 @@ int             lines_to_next_header = -1;
 char           *lstart_format = NULL;
 char            delimiter_option = '\0';
 int             negate_selection = -1;
+int             output_type = -1;
 int             running_only = -1;
 int             page_size = -1;  // "int" for math reasons?
 unsigned        personality = 0xffffffff;
@@ -210,6 +211,7 @@ const char     *sysv_fl_format = (const char *)0xdeadbeef;
 const char     *sysv_j_format = (const char *)0xdeadbeef;
 const char     *sysv_l_format = (const char *)0xdeadbeef;
 unsigned        thread_flags = 0xffffffff;
+int             top_count = -1;
 int             unix_f_option = -1;
 int             user_is_number = -1;
 int             wchan_is_number = -1;
@@ -502,6 +504,8 @@ void reset_global(void){
       fprintf(stderr, _("fatal library error, context\n"));
       exit(EXIT_FAILURE);
     }
+    // we only read those strings (and just until the next reap)
+    procps_pids_borrow(Pids_info, 1);
   }
 
   Pids_items[0] = PIDS_TTY;
@@ -530,12 +534,14 @@ void reset_global(void){
   include_dead_children = 0;
   lines_to_next_header  = 1;
   negate_selection      = 0;
+  output_type           = OUTPUT_TEXT;
   page_size             = getpagesize();
   running_only          = 0;
   selection_list        = NULL;
   simple_select         = 0;
   sort_list             = NULL;
   thread_flags          = 0;
+  top_count             = 0;
   unix_f_option         = 0;
   user_is_number        = 0;
   wchan_is_number       = 0;
@@ -151,8 +151,10 @@ void do_help (const char *opt, int rc) {
     fputs(_("  X                   register format\n"), out);
     fputs(_(" -y                   do not show flags, show rss vs. addr (used with -l)\n"), out);
     fputs(_("     --context        display security context (for SELinux)\n"), out);
+    fputs(_("     --csv            comma-separated values, one row per process\n"), out);
     fputs(_("     --delimiter <d>  Use <d> as a column delimiter instead of variable space\n"), out);
     fputs(_("     --headers        repeat header lines, one per page\n"), out);
+    fputs(_("     --json           one JSON object per process\n"), out);
     fputs(_("     --no-headers     do not print header at all\n"), out);
     fputs(_("     --cols, --columns, --width <num>\n"
       "                      set screen width\n"), out);
@@ -176,6 +178,7 @@ void do_help (const char *opt, int rc) {
     fputs(_("  L                   show format specifiers\n"), out);
     fputs(_("  n                   display numeric uid and wchan\n"), out);
     fputs(_("  S,    --cumulative  include some dead child process data\n"), out);
+    fputs(_("     --top <num>      show only the first <num> processes\n"), out);
     fputs(_(" -y                   do not show flags, show rss (only with -l)\n"), out);
     fputs(_(" -V, V, --version     display version information and exit\n"), out);
     fputs(_(" -w, w                unlimited output width\n"), out);
@@ -2203,6 +2203,137 @@ static void check_header_width(void){
 
 static char *saved_outbuf;
 
+/* whole rows are assembled here, so stdio sees just one fwrite per row */
+#define ROWBUF_SIZE (64*1024)
+
+static char rowbuf[ROWBUF_SIZE];
+
+static void row_add(size_t *restrict rowlen, const char *restrict src, size_t n){
+  if(*rowlen + n > ROWBUF_SIZE){
+    fwrite(rowbuf, *rowlen, 1, stdout);
+    *rowlen = 0;
+  }
+  if(n > ROWBUF_SIZE){  /* a (very) unlimited column, can't be helped */
+    fwrite(src, n, 1, stdout);
+    return;
+  }
+  memcpy(rowbuf + *rowlen, src, n);
+  *rowlen += n;
+}
+
+/* JSON string contents: quote, backslash and control characters escaped */
+static void row_add_json(size_t *restrict rowlen, const char *restrict src, size_t n){
+  static const char hex[] = "0123456789abcdef";
+  char esc[6] = { '\\', 'u', '0', '0' };
+  size_t i, run = 0;
+
+  for(i = 0; i < n; i++){
+    unsigned char c = src[i];
+    if(c >= 0x20 && c != '"' && c != '\\') continue;
+    row_add(rowlen, src + run, i - run);
+    run = i + 1;
+    if(c == '"' || c == '\\'){
+      esc[1] = c;
+      row_add(rowlen, esc, 2);
+      esc[1] = 'u';
+      continue;
+    }
+    esc[4] = hex[c >> 4];
+    esc[5] = hex[c & 0xf];
+    row_add(rowlen, esc, 6);
+  }
+  row_add(rowlen, src + run, n - run);
+}
+
+/* RFC 4180 field: quoted only when it must be, with quotes doubled */
+static void row_add_csv(size_t *restrict rowlen, const char *restrict src, size_t n){
+  size_t i, run = 0;
+
+  if(!memchr(src, ',', n) && !memchr(src, '"', n)
+  && !memchr(src, '\n', n) && !memchr(src, '\r', n)){
+    row_add(rowlen, src, n);
+    return;
+  }
+  row_add(rowlen, "\"", 1);
+  for(i = 0; i < n; i++){
+    if(src[i] != '"') continue;
+    row_add(rowlen, src + run, i + 1 - run);
+    run = i;                 /* that quote goes out again, so doubled */
+  }
+  row_add(rowlen, src + run, n - run);
+  row_add(rowlen, "\"", 1);
+}
+
+/* the --json key for a format specifier, where a macro format like -f
+   uses an internal one in place of what a user would have asked for */
+const char *json_key(const char *spec){
+  if(!strcmp(spec, "uid_hack")) return "user";
+  return spec;
+}
+
+/* a plain decimal number, which JSON can carry without quotes */
+static int is_number(const char *s, size_t n){
+  size_t i = 0, digits;
+
+  if(i < n && s[i] == '-') i++;
+  for(digits = i; i < n && isdigit((unsigned char)s[i]); i++);
+  if(i == digits || (s[digits] == '0' && i - digits > 1)) return 0;
+  if(i < n && s[i] == '.'){
+    for(digits = ++i; i < n && isdigit((unsigned char)s[i]); i++);
+    if(i == digits) return 0;
+  }
+  return i == n;
+}
+
+/* one JSON object or CSV row (NULL proc: the CSV header), values unpadded */
+static void show_one_machine(const proc_t *restrict const p, const format_node *restrict fmt){
+  char *restrict const outbuf = saved_outbuf;
+  size_t rowlen = 0;  /* what's in rowbuf */
+  const char *val, *val_key;
+  int amount, first = 1;
+  size_t sz;
+
+  if(output_type == OUTPUT_JSON) row_add(&rowlen, "{", 1);
+  for(; fmt; fmt = fmt->next){
+    if(!fmt->pr) continue;   /* AIX filler, just decoration */
+    if(p){
+      /* no column widths here, so nothing should be truncated */
+      max_rightward = max_leftward = OUTBUF_SIZE-1;
+      amount = (*fmt->pr)(outbuf,p);
+      if(amount < 0) outbuf[amount = 0] = '\0';
+      else if(amount >= OUTBUF_SIZE) outbuf[amount = OUTBUF_SIZE-1] = '\0';
+      outbuf[OUTBUF_SIZE-1] = '\0';
+      val = outbuf;
+    }else
+      val = fmt->name;
+    sz = strlen(val);
+    /* a few pr_ functions pad for themselves */
+    while(sz && val[0] == ' '){ val++; sz--; }
+    while(sz && val[sz-1] == ' ') sz--;
+
+    if(!first) row_add(&rowlen, ",", 1);
+    first = 0;
+    if(output_type == OUTPUT_CSV){
+      row_add_csv(&rowlen, val, sz);
+      continue;
+    }
+    val_key = json_key(fmt->spec);
+    row_add(&rowlen, "\"", 1);
+    row_add_json(&rowlen, val_key, strlen(val_key));
+    row_add(&rowlen, "\":", 2);
+    if(is_number(val, sz)){
+      row_add(&rowlen, val, sz);
+      continue;
+    }
+    row_add(&rowlen, "\"", 1);
+    row_add_json(&rowlen, val, sz);
+    row_add(&rowlen, "\"", 1);
+  }
+  if(output_type == OUTPUT_JSON) row_add(&rowlen, "}\n", 2);
+  else row_add(&rowlen, "\r\n", 2);
+  fwrite(rowbuf, rowlen, 1, stdout);
+}
+
 void show_one_proc(const proc_t *restrict const p, const format_node *restrict fmt){
   /* unknown: maybe set correct & actual to 1, remove +/- 1 below */
   int correct  = 0;  /* screen position we should be at */
@@ -2214,6 +2345,7 @@ void show_one_proc(const proc_t *restrict const p, const format_node *restrict f
   int legit    = 0;  /* legitimately stolen extra space */
   int sz       = 0;  /* real size of data in outbuffer */
   int tmpspace = 0;
+  size_t rowlen = 0;  /* what's in rowbuf */
   char *restrict const outbuf = saved_outbuf;
   static int did_stuff = 0;  /* have we ever printed anything? */
 
@@ -2234,6 +2366,10 @@ void show_one_proc(const proc_t *restrict const p, const format_node *restrict f
     }
   }
   did_stuff = 1;
+  if(output_type){
+    show_one_machine(p,fmt);
+    return;
+  }
   if(active_cols>(int)OUTBUF_SIZE) fprintf(stderr,_("fix bigness error\n"));
 
   /* print row start sequence */
@@ -2341,13 +2477,14 @@ void show_one_proc(const proc_t *restrict const p, const format_node *restrict f
 
     /* print data, set x position stuff */
     if(!fmt->next){
-      /* Last column. Write padding + data + newline all together. */
+      /* Last column. Write the row with padding + data + newline. */
       outbuf[sz] = '\n';
-      fwrite(outbuf-space, space+sz+1, 1, stdout);
+      row_add(&rowlen, outbuf-space, space+sz+1);
+      fwrite(rowbuf, rowlen, 1, stdout);
       break;
     }
-    /* Not the last column. Write padding + data together. */
-    fwrite(outbuf-space, space+sz, 1, stdout);
+    /* Not the last column. Add padding + data together. */
+    row_add(&rowlen, outbuf-space, space+sz);
     actual  += space+amount;
     correct += fmt->width;
     correct += legit;        /* adjust for SIGNAL expansion */
@@ -2395,8 +2532,12 @@ void init_output(void)
 	mprotect(outbuf, page_size, PROT_READ);
     mprotect(outbuf + page_size*outbuf_pages, page_size, PROT_NONE); // guard page
     saved_outbuf = outbuf + SPACE_AMOUNT;
+    /* when not a terminal, let those rows collect into fewer writes */
+    if(!isatty(STDOUT_FILENO))
+        setvbuf(stdout, NULL, _IOFBF, ROWBUF_SIZE);
     // available space:  page_size*outbuf_pages-SPACE_AMOUNT
     seconds_since_1970 = time(NULL);
 
-    check_header_width();
+    if(!output_type)  /* JSON and CSV have no column widths */
+        check_header_width();
 }
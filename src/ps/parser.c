@@ -820,6 +820,7 @@ static const char *parse_gnu_option(void){
   {"cols",          &&case_cols},
   {"columns",       &&case_columns},
   {"context",       &&case_context},
+  {"csv",           &&case_csv},
   {"cumulative",    &&case_cumulative},
   {"date-format",   &&case_dateformat},
   {"delimiter",     &&case_delimiter},
@@ -833,6 +834,7 @@ static const char *parse_gnu_option(void){
   {"headings",      &&case_headings},
 //{"help",          &&case_help},        /* now TRANSLATABLE ! */
   {"info",          &&case_info},
+  {"json",          &&case_json},
   {"lines",         &&case_lines},
   {"no-header",     &&case_no_header},
   {"no-headers",    &&case_no_headers},
@@ -849,6 +851,7 @@ static const char *parse_gnu_option(void){
   {"sid",           &&case_sid},
   {"signames",      &&case_signames},
   {"sort",          &&case_sort},
+  {"top",           &&case_top},
   {"tty",           &&case_tty},
   {"user",          &&case_user},        /* euid */
   {"version",       &&case_version},
@@ -906,6 +909,12 @@ static const char *parse_gnu_option(void){
       }
     }
     return _("number of columns must follow --cols, --width, or --columns");
+  case_csv:
+    trace("--csv\n");
+    if(s[sl]) return _("option --csv does not take an argument");
+    if(output_type) return _("only one output type may be specified");
+    output_type = OUTPUT_CSV;
+    return NULL;
   case_cumulative:
     trace("--cumulative\n");
     if(s[sl]) return _("option --cumulative does not take an argument");
@@ -979,6 +988,12 @@ static const char *parse_gnu_option(void){
     self_info();
     exit(0);
     return NULL;
+  case_json:
+    trace("--json\n");
+    if(s[sl]) return _("option --json does not take an argument");
+    if(output_type) return _("only one output type may be specified");
+    output_type = OUTPUT_JSON;
+    return NULL;
   case_pid:
     trace("--pid\n");
     arg = grab_gnu_arg();
@@ -1035,6 +1050,19 @@ static const char *parse_gnu_option(void){
     if(!arg) return _("long sort specification must follow --sort");
     defer_sf_option(arg, SF_G_sort);
     return NULL;
+  case_top:
+    trace("--top\n");
+    arg = grab_gnu_arg();
+    if(arg && *arg){
+      long t;
+      char *endptr;
+      t = strtol(arg, &endptr, 0);
+      if(!*endptr && (t>0) && (t<2000000000)){
+        top_count = (int)t;
+        return NULL;
+      }
+    }
+    return _("number of processes must follow --top");
   case_tty:
     trace("--tty\n");
     arg = grab_gnu_arg();
@@ -66,6 +66,7 @@ static format_node *do_one_spec(const char *spec, const char *override){
       thisnode->width = w1;
       thisnode->name = xstrdup(fs->head);
     }
+    thisnode->spec = fs->spec;
     thisnode->pr = fs->pr;
     thisnode->vendor = fs->vendor;
     thisnode->flags = fs->flags;
@@ -187,6 +188,7 @@ static const char *aix_format_parse(sf_node *sfn){
       fnode = xmalloc(sizeof(format_node));
       fnode->width = len < INT_MAX ? len : INT_MAX;
       fnode->name = xstrdup(buf);
+      fnode->spec = NULL;
       fnode->pr = NULL;     /* checked for */
       fnode->vendor = AIX;
       fnode->flags = CF_PRINT_EVERY_TIME;
@@ -701,6 +703,7 @@ static const char *generate_sysv_list(void){
       fn = xmalloc(sizeof(format_node));
       fn->width = 1;
       fn->name = xstrdup(":");
+      fn->spec = NULL;
       fn->pr = NULL;     /* checked for */
       fn->vendor = AIX;   /* yes, for SGI weirdness */
       fn->flags = CF_PRINT_EVERY_TIME;
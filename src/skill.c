@@ -272,41 +272,52 @@ static void show_lists(void)
         fprintf(stderr, "\n");
 }
 
+/*
+ * Every test here can be satisfied with just the 'stat' read, so tasks
+ * that fail are then spared the tty name and user name lookups.
+ */
+static int filter_procs(struct pids_stack *stack, void *data)
+{
+ #define PIDS_GETINT(e) PIDS_VAL(EU_ ## e, s_int, stack)
+ #define PIDS_GETUNT(e) PIDS_VAL(EU_ ## e, u_int, stack)
+ #define PIDS_GETSTR(e) PIDS_VAL(EU_ ## e, str, stack)
+    (void)data;
+
+    if (PIDS_GETINT(PID) == my_pid || PIDS_GETINT(PID) == 0)
+        return 0;
+    if (pids && !match_intlist(PIDS_GETINT(PID), pid_count, pids))
+        return 0;
+    if (uids && !match_intlist(PIDS_GETUNT(EUID), uid_count, (int *)uids))
+        return 0;
+    if (ttys && !match_intlist(PIDS_GETINT(TTY), tty_count, ttys))
+        return 0;
+    if (cmds && !match_strlist(PIDS_GETSTR(CMD), cmd_count, cmds))
+        return 0;
+    if (namespaces && !match_ns(PIDS_GETINT(PID)))
+        return 0;
+    return 1;
+
+ #undef PIDS_GETINT
+ #undef PIDS_GETUNT
+ #undef PIDS_GETSTR
+}
+
 static void scan_procs(struct run_time_conf_t *run_time)
 {
- #define PIDS_GETINT(e) PIDS_VAL(EU_ ## e, s_int, reap->stacks[i])
- #define PIDS_GETUNT(e) PIDS_VAL(EU_ ## e, u_int, reap->stacks[i])
- #define PIDS_GETSTR(e) PIDS_VAL(EU_ ## e, str, reap->stacks[i])
     struct pids_fetch *reap;
     int i, total_procs;
 
     if (procps_pids_new(&Pids_info, items, 6) < 0)
         errx(EXIT_FAILURE,
               _("Unable to create pid Pids_info structure"));
+    procps_pids_filter(Pids_info, filter_procs, NULL);
     if ((reap = procps_pids_reap(Pids_info, PIDS_FETCH_TASKS_ONLY)) == NULL)
         errx(EXIT_FAILURE,
               _("Unable to load process information"));
 
     total_procs = reap->counts->total;
-    for (i=0; i < total_procs; i++) {
-        if (PIDS_GETINT(PID) == my_pid || PIDS_GETINT(PID) == 0)
-            continue;
-	if (pids && !match_intlist(PIDS_GETINT(PID), pid_count, pids))
-	    continue;
-        if (uids && !match_intlist(PIDS_GETUNT(EUID), uid_count, (int *)uids))
-            continue;
-        if (ttys && !match_intlist(PIDS_GETINT(TTY), tty_count, ttys))
-            continue;
-        if (cmds && !match_strlist(PIDS_GETSTR(CMD), cmd_count, cmds))
-            continue;
-        if (namespaces && !match_ns(PIDS_GETINT(PID)))
-            continue;
+    for (i=0; i < total_procs; i++)
         nice_or_kill(reap->stacks[i], run_time);
-    }
-
- #undef PIDS_GETINT
- #undef PIDS_GETUNT
- #undef PIDS_GETSTR
 }
 
 /* skill and snice help */
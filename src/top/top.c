@@ -147,6 +147,7 @@ static int Batch = 0,           // batch mode, collect no input, dumb output
            Loops = -1,          // number of iterations, -1 loops forever
            Secure_mode = 0,     // set if some functionality restricted
            Width_mode = 0,      // set w/ 'w' - potential output override
+           Json_mode = 0,       // set w/ 'J' - batch frames output as json
            Thread_mode = 0;     // set w/ 'H' - show threads vs. tasks
 
         /* Unchangeable cap's stuff built just once (if at all) and
@@ -1930,6 +1931,7 @@ static struct {
    int           scale;         // scaled target, if applicable
    const int     align;         // the default column alignment flag
    enum pids_item item;         // the new libproc item enum identifier
+   const char   *key;           // untranslated name, as used for JSON keys
 } Fieldstab[] = {
    // these identifiers reflect the default column alignment but they really
    // contain the WIN_t flag used to check/change justification at run-time!
@@ -1940,90 +1942,96 @@ static struct {
         a -1 width represents variable width columns
         a  0 width represents columns set once at startup (see zap_fieldstab)
 
-     .width  .scale  .align    .item
-     ------  ------  --------  ------------------- */
-   {     0,     -1,  A_right,  PIDS_ID_PID         },  // s_int    EU_PID
-   {     0,     -1,  A_right,  PIDS_ID_PPID        },  // s_int    EU_PPD
-   {     5,     -1,  A_right,  PIDS_ID_EUID        },  // u_int    EU_UED
-   {     8,     -1,  A_left,   PIDS_ID_EUSER       },  // str      EU_UEN
-   {     5,     -1,  A_right,  PIDS_ID_RUID        },  // u_int    EU_URD
-   {     8,     -1,  A_left,   PIDS_ID_RUSER       },  // str      EU_URN
-   {     5,     -1,  A_right,  PIDS_ID_SUID        },  // u_int    EU_USD
-   {     8,     -1,  A_left,   PIDS_ID_SUSER       },  // str      EU_USN
-   {     5,     -1,  A_right,  PIDS_ID_EGID        },  // u_int    EU_GID
-   {     8,     -1,  A_left,   PIDS_ID_EGROUP      },  // str      EU_GRP
-   {     0,     -1,  A_right,  PIDS_ID_PGRP        },  // s_int    EU_PGD
-   {     8,     -1,  A_left,   PIDS_TTY_NAME       },  // str      EU_TTY
-   {     0,     -1,  A_right,  PIDS_ID_TPGID       },  // s_int    EU_TPG
-   {     0,     -1,  A_right,  PIDS_ID_SESSION     },  // s_int    EU_SID
-   {     3,     -1,  A_right,  PIDS_PRIORITY       },  // s_int    EU_PRI
-   {     3,     -1,  A_right,  PIDS_NICE           },  // s_int    EU_NCE
-   {     3,     -1,  A_right,  PIDS_NLWP           },  // s_int    EU_THD
-   {     2,     -1,  A_right,  PIDS_PROCESSOR      },  // s_int    EU_CPN
-   {     5,     -1,  A_right,  PIDS_TICS_ALL_DELTA },  // u_int    EU_CPU
-   {     6,     -1,  A_right,  PIDS_TICS_ALL       },  // ull_int  EU_TME
-   {     9,     -1,  A_right,  PIDS_TICS_ALL       },  // ull_int  EU_TM2
-   {     5,     -1,  A_right,  PIDS_MEM_RES        },  // ul_int   EU_MEM
-   {     7,  SK_Kb,  A_right,  PIDS_MEM_VIRT       },  // ul_int   EU_VRT
-   {     6,  SK_Kb,  A_right,  PIDS_VM_SWAP        },  // ul_int   EU_SWP
-   {     6,  SK_Kb,  A_right,  PIDS_MEM_RES        },  // ul_int   EU_RES
-   {     6,  SK_Kb,  A_right,  PIDS_MEM_CODE       },  // ul_int   EU_COD
-   {     7,  SK_Kb,  A_right,  PIDS_MEM_DATA       },  // ul_int   EU_DAT
-   {     6,  SK_Kb,  A_right,  PIDS_MEM_SHR        },  // ul_int   EU_SHR
-   {     4,     -1,  A_right,  PIDS_FLT_MAJ        },  // ul_int   EU_FL1
-   {     4,     -1,  A_right,  PIDS_FLT_MIN        },  // ul_int   EU_FL2
-   {     4,     -1,  A_right,  PIDS_noop           },  // ul_int   EU_DRT ( always 0 w/ since 2.6 )
-   {     1,     -1,  A_right,  PIDS_STATE          },  // s_ch     EU_STA
-   {    -1,     -1,  A_left,   PIDS_CMD            },  // str      EU_CMD
-   {    10,     -1,  A_left,   PIDS_WCHAN_NAME     },  // str      EU_WCH
-   {     8,     -1,  A_left,   PIDS_FLAGS          },  // ul_int   EU_FLG
-   {    -1,     -1,  A_left,   PIDS_CGROUP         },  // str      EU_CGR
-   {    -1,     -1,  A_left,   PIDS_SUPGIDS        },  // str      EU_SGD
-   {    -1,     -1,  A_left,   PIDS_SUPGROUPS      },  // str      EU_SGN
-   {     0,     -1,  A_right,  PIDS_ID_TGID        },  // s_int    EU_TGD
-   {     5,     -1,  A_right,  PIDS_OOM_ADJ        },  // s_int    EU_OOA
-   {     4,     -1,  A_right,  PIDS_OOM_SCORE      },  // s_int    EU_OOM
-   {    -1,     -1,  A_left,   PIDS_ENVIRON        },  // str      EU_ENV
-   {     3,     -1,  A_right,  PIDS_FLT_MAJ_DELTA  },  // s_int    EU_FV1
-   {     3,     -1,  A_right,  PIDS_FLT_MIN_DELTA  },  // s_int    EU_FV2
-   {     6,  SK_Kb,  A_right,  PIDS_VM_USED        },  // ul_int   EU_USE
-   {    10,     -1,  A_right,  PIDS_NS_IPC         },  // ul_int   EU_NS1
-   {    10,     -1,  A_right,  PIDS_NS_MNT         },  // ul_int   EU_NS2
-   {    10,     -1,  A_right,  PIDS_NS_NET         },  // ul_int   EU_NS3
-   {    10,     -1,  A_right,  PIDS_NS_PID         },  // ul_int   EU_NS4
-   {    10,     -1,  A_right,  PIDS_NS_USER        },  // ul_int   EU_NS5
-   {    10,     -1,  A_right,  PIDS_NS_UTS         },  // ul_int   EU_NS6
-   {     8,     -1,  A_left,   PIDS_LXCNAME        },  // str      EU_LXC
-   {     6,  SK_Kb,  A_right,  PIDS_VM_RSS_ANON    },  // ul_int   EU_RZA
-   {     6,  SK_Kb,  A_right,  PIDS_VM_RSS_FILE    },  // ul_int   EU_RZF
-   {     6,  SK_Kb,  A_right,  PIDS_VM_RSS_LOCKED  },  // ul_int   EU_RZL
-   {     6,  SK_Kb,  A_right,  PIDS_VM_RSS_SHARED  },  // ul_int   EU_RZS
-   {    -1,     -1,  A_left,   PIDS_CGNAME         },  // str      EU_CGN
-   {     2,     -1,  A_right,  PIDS_PROCESSOR_NODE },  // s_int    EU_NMA
-   {     5,     -1,  A_right,  PIDS_ID_LOGIN       },  // s_int    EU_LID
-   {    -1,     -1,  A_left,   PIDS_EXE            },  // str      EU_EXE
-   {     6,  SK_Kb,  A_right,  PIDS_SMAP_RSS       },  // ul_int   EU_RSS
-   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PSS       },  // ul_int   EU_PSS
-   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PSS_ANON  },  // ul_int   EU_PZA
-   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PSS_FILE  },  // ul_int   EU_PZF
-   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PSS_SHMEM },  // ul_int   EU_PZS
-   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PRV_TOTAL },  // ul_int   EU_USS
-   {     6,     -1,  A_right,  PIDS_IO_READ_BYTES  },  // ul_int   EU_IRB
-   {     5,     -1,  A_right,  PIDS_IO_READ_OPS    },  // ul_int   EU_IRO
-   {     6,     -1,  A_right,  PIDS_IO_WRITE_BYTES },  // ul_int   EU_IWB
-   {     5,     -1,  A_right,  PIDS_IO_WRITE_OPS   },  // ul_int   EU_IWO
-   {     5,     -1,  A_right,  PIDS_AUTOGRP_ID     },  // s_int    EU_AGI
-   {     4,     -1,  A_right,  PIDS_AUTOGRP_NICE   },  // s_int    EU_AGN
-   {     7,     -1,  A_right,  PIDS_TICS_BEGAN     },  // ull_int  EU_TM3
-   {     7,     -1,  A_right,  PIDS_TIME_ELAPSED   },  // real     EU_TM4
-   {     6,     -1,  A_right,  PIDS_UTILIZATION    },  // real     EU_CUU
-   {     7,     -1,  A_right,  PIDS_UTILIZATION_C  },  // real     EU_CUC
-   {    10,     -1,  A_right,  PIDS_NS_CGROUP      },  // ul_int   EU_NS7
-   {    10,     -1,  A_right,  PIDS_NS_TIME        },  // ul_int   EU_NS8
-   {     3,     -1,  A_left,   PIDS_SCHED_CLASSSTR },  // str      EU_CLS
-   {     8,     -1,  A_left,   PIDS_DOCKER_ID      },  // str      EU_DKR
-   {     3,     -1,  A_right,  PIDS_OPEN_FILES     }   // str      EU_FDS
-#define eu_LAST        EU_FDS
+     .width  .scale  .align    .item                      .key
+     ------  ------  --------  -------------------------  ---------- */
+   {     0,     -1,  A_right,  PIDS_ID_PID,               "PID"      },  // s_int    EU_PID
+   {     0,     -1,  A_right,  PIDS_ID_PPID,              "PPID"     },  // s_int    EU_PPD
+   {     5,     -1,  A_right,  PIDS_ID_EUID,              "UID"      },  // u_int    EU_UED
+   {     8,     -1,  A_left,   PIDS_ID_EUSER,             "USER"     },  // str      EU_UEN
+   {     5,     -1,  A_right,  PIDS_ID_RUID,              "RUID"     },  // u_int    EU_URD
+   {     8,     -1,  A_left,   PIDS_ID_RUSER,             "RUSER"    },  // str      EU_URN
+   {     5,     -1,  A_right,  PIDS_ID_SUID,              "SUID"     },  // u_int    EU_USD
+   {     8,     -1,  A_left,   PIDS_ID_SUSER,             "SUSER"    },  // str      EU_USN
+   {     5,     -1,  A_right,  PIDS_ID_EGID,              "GID"      },  // u_int    EU_GID
+   {     8,     -1,  A_left,   PIDS_ID_EGROUP,            "GROUP"    },  // str      EU_GRP
+   {     0,     -1,  A_right,  PIDS_ID_PGRP,              "PGRP"     },  // s_int    EU_PGD
+   {     8,     -1,  A_left,   PIDS_TTY_NAME,             "TTY"      },  // str      EU_TTY
+   {     0,     -1,  A_right,  PIDS_ID_TPGID,             "TPGID"    },  // s_int    EU_TPG
+   {     0,     -1,  A_right,  PIDS_ID_SESSION,           "SID"      },  // s_int    EU_SID
+   {     3,     -1,  A_right,  PIDS_PRIORITY,             "PR"       },  // s_int    EU_PRI
+   {     3,     -1,  A_right,  PIDS_NICE,                 "NI"       },  // s_int    EU_NCE
+   {     3,     -1,  A_right,  PIDS_NLWP,                 "nTH"      },  // s_int    EU_THD
+   {     2,     -1,  A_right,  PIDS_PROCESSOR,            "P"        },  // s_int    EU_CPN
+   {     5,     -1,  A_right,  PIDS_TICS_ALL_DELTA,       "%CPU"     },  // u_int    EU_CPU
+   {     6,     -1,  A_right,  PIDS_TICS_ALL,             "TIME"     },  // ull_int  EU_TME
+   {     9,     -1,  A_right,  PIDS_TICS_ALL,             "TIME+"    },  // ull_int  EU_TM2
+   {     5,     -1,  A_right,  PIDS_MEM_RES,              "%MEM"     },  // ul_int   EU_MEM
+   {     7,  SK_Kb,  A_right,  PIDS_MEM_VIRT,             "VIRT"     },  // ul_int   EU_VRT
+   {     6,  SK_Kb,  A_right,  PIDS_VM_SWAP,              "SWAP"     },  // ul_int   EU_SWP
+   {     6,  SK_Kb,  A_right,  PIDS_MEM_RES,              "RES"      },  // ul_int   EU_RES
+   {     6,  SK_Kb,  A_right,  PIDS_MEM_CODE,             "CODE"     },  // ul_int   EU_COD
+   {     7,  SK_Kb,  A_right,  PIDS_MEM_DATA,             "DATA"     },  // ul_int   EU_DAT
+   {     6,  SK_Kb,  A_right,  PIDS_MEM_SHR,              "SHR"      },  // ul_int   EU_SHR
+   {     4,     -1,  A_right,  PIDS_FLT_MAJ,              "nMaj"     },  // ul_int   EU_FL1
+   {     4,     -1,  A_right,  PIDS_FLT_MIN,              "nMin"     },  // ul_int   EU_FL2
+   {     4,     -1,  A_right,  PIDS_noop,                 "nDRT"     },  // ul_int   EU_DRT ( always 0 w/ since 2.6 )
+   {     1,     -1,  A_right,  PIDS_STATE,                "S"        },  // s_ch     EU_STA
+   {    -1,     -1,  A_left,   PIDS_CMD,                  "COMMAND"  },  // str      EU_CMD
+   {    10,     -1,  A_left,   PIDS_WCHAN_NAME,           "WCHAN"    },  // str      EU_WCH
+   {     8,     -1,  A_left,   PIDS_FLAGS,                "Flags"    },  // ul_int   EU_FLG
+   {    -1,     -1,  A_left,   PIDS_CGROUP,               "CGROUPS"  },  // str      EU_CGR
+   {    -1,     -1,  A_left,   PIDS_SUPGIDS,              "SUPGIDS"  },  // str      EU_SGD
+   {    -1,     -1,  A_left,   PIDS_SUPGROUPS,            "SUPGRPS"  },  // str      EU_SGN
+   {     0,     -1,  A_right,  PIDS_ID_TGID,              "TGID"     },  // s_int    EU_TGD
+   {     5,     -1,  A_right,  PIDS_OOM_ADJ,              "OOMa"     },  // s_int    EU_OOA
+   {     4,     -1,  A_right,  PIDS_OOM_SCORE,            "OOMs"     },  // s_int    EU_OOM
+   {    -1,     -1,  A_left,   PIDS_ENVIRON,              "ENVIRON"  },  // str      EU_ENV
+   {     3,     -1,  A_right,  PIDS_FLT_MAJ_DELTA,        "vMj"      },  // s_int    EU_FV1
+   {     3,     -1,  A_right,  PIDS_FLT_MIN_DELTA,        "vMn"      },  // s_int    EU_FV2
+   {     6,  SK_Kb,  A_right,  PIDS_VM_USED,              "USED"     },  // ul_int   EU_USE
+   {    10,     -1,  A_right,  PIDS_NS_IPC,               "nsIPC"    },  // ul_int   EU_NS1
+   {    10,     -1,  A_right,  PIDS_NS_MNT,               "nsMNT"    },  // ul_int   EU_NS2
+   {    10,     -1,  A_right,  PIDS_NS_NET,               "nsNET"    },  // ul_int   EU_NS3
+   {    10,     -1,  A_right,  PIDS_NS_PID,               "nsPID"    },  // ul_int   EU_NS4
+   {    10,     -1,  A_right,  PIDS_NS_USER,              "nsUSER"   },  // ul_int   EU_NS5
+   {    10,     -1,  A_right,  PIDS_NS_UTS,               "nsUTS"    },  // ul_int   EU_NS6
+   {     8,     -1,  A_left,   PIDS_LXCNAME,              "LXC"      },  // str      EU_LXC
+   {     6,  SK_Kb,  A_right,  PIDS_VM_RSS_ANON,          "RSan"     },  // ul_int   EU_RZA
+   {     6,  SK_Kb,  A_right,  PIDS_VM_RSS_FILE,          "RSfd"     },  // ul_int   EU_RZF
+   {     6,  SK_Kb,  A_right,  PIDS_VM_RSS_LOCKED,        "RSlk"     },  // ul_int   EU_RZL
+   {     6,  SK_Kb,  A_right,  PIDS_VM_RSS_SHARED,        "RSsh"     },  // ul_int   EU_RZS
+   {    -1,     -1,  A_left,   PIDS_CGNAME,               "CGNAME"   },  // str      EU_CGN
+   {     2,     -1,  A_right,  PIDS_PROCESSOR_NODE,       "NU"       },  // s_int    EU_NMA
+   {     5,     -1,  A_right,  PIDS_ID_LOGIN,             "LOGID"    },  // s_int    EU_LID
+   {    -1,     -1,  A_left,   PIDS_EXE,                  "EXE"      },  // str      EU_EXE
+   {     6,  SK_Kb,  A_right,  PIDS_SMAP_RSS,             "RSS"      },  // ul_int   EU_RSS
+   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PSS,             "PSS"      },  // ul_int   EU_PSS
+   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PSS_ANON,        "PSan"     },  // ul_int   EU_PZA
+   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PSS_FILE,        "PSfd"     },  // ul_int   EU_PZF
+   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PSS_SHMEM,       "PSsh"     },  // ul_int   EU_PZS
+   {     6,  SK_Kb,  A_right,  PIDS_SMAP_PRV_TOTAL,       "USS"      },  // ul_int   EU_USS
+   {     6,     -1,  A_right,  PIDS_IO_READ_BYTES,        "ioR"      },  // ul_int   EU_IRB
+   {     5,     -1,  A_right,  PIDS_IO_READ_OPS,          "ioRop"    },  // ul_int   EU_IRO
+   {     6,     -1,  A_right,  PIDS_IO_WRITE_BYTES,       "ioW"      },  // ul_int   EU_IWB
+   {     5,     -1,  A_right,  PIDS_IO_WRITE_OPS,         "ioWop"    },  // ul_int   EU_IWO
+   {     5,     -1,  A_right,  PIDS_AUTOGRP_ID,           "AGID"     },  // s_int    EU_AGI
+   {     4,     -1,  A_right,  PIDS_AUTOGRP_NICE,         "AGNI"     },  // s_int    EU_AGN
+   {     7,     -1,  A_right,  PIDS_TICS_BEGAN,           "STARTED"  },  // ull_int  EU_TM3
+   {     7,     -1,  A_right,  PIDS_TIME_ELAPSED,         "ELAPSED"  },  // real     EU_TM4
+   {     6,     -1,  A_right,  PIDS_UTILIZATION,          "%CUU"     },  // real     EU_CUU
+   {     7,     -1,  A_right,  PIDS_UTILIZATION_C,        "%CUC"     },  // real     EU_CUC
+   {    10,     -1,  A_right,  PIDS_NS_CGROUP,            "nsCGROUP" },  // ul_int   EU_NS7
+   {    10,     -1,  A_right,  PIDS_NS_TIME,              "nsTIME"   },  // ul_int   EU_NS8
+   {     3,     -1,  A_left,   PIDS_SCHED_CLASSSTR,       "CLS"      },  // str      EU_CLS
+   {     8,     -1,  A_left,   PIDS_DOCKER_ID,            "Docker"   },  // str      EU_DKR
+   {     3,     -1,  A_right,  PIDS_OPEN_FILES,           "nFD"      },  // str      EU_FDS
+   {     6,     -1,  A_right,  PIDS_IO_READ_BYTES_DELTA,  "vioR"     },  // ul_int   EU_VRB
+   {     5,     -1,  A_right,  PIDS_IO_READ_OPS_DELTA,    "vRop"     },  // ul_int   EU_VRO
+   {     6,     -1,  A_right,  PIDS_IO_WRITE_BYTES_DELTA, "vioW"     },  // ul_int   EU_VWB
+   {     5,     -1,  A_right,  PIDS_IO_WRITE_OPS_DELTA,   "vWop"     },  // ul_int   EU_VWO
+   {     4,     -1,  A_right,  PIDS_CTXSW_VOL_DELTA,      "vVcs"     },  // ul_int   EU_VCV
+   {     4,     -1,  A_right,  PIDS_CTXSW_INVOL_DELTA,    "vIcs"     }   // ul_int   EU_VCI
+#define eu_LAST        EU_VCI
 // xtra Fieldstab 'pseudo pflag' entries for the newlib interface . . . . . . .
 #define eu_CMDLINE     eu_LAST +1
 #define eu_TICS_ALL_C  eu_LAST +2
@@ -2035,15 +2043,15 @@ static struct {
 #define eu_TREE_LVL    eu_LAST +8
 #define eu_TREE_ADD    eu_LAST +9
 #define eu_RESET       eu_TREE_HID       // demarcation for reset to zero (PIDS_extra)
-   , {  -1, -1, -1,  PIDS_CMDLINE        }  // str      ( if Show_CMDLIN, eu_CMDLINE    )
-   , {  -1, -1, -1,  PIDS_TICS_ALL_C     }  // ull_int  ( if Show_CTIMES, eu_TICS_ALL_C )
-   , {  -1, -1, -1,  PIDS_ID_FUID        }  // u_int    ( if a usrseltyp, eu_ID_FUID    )
-   , {  -1, -1, -1,  PIDS_CAPS_PERMITTED }  // str      ( if kbd_CtrlA,   eu_CAPABILITY )
-   , {  -1, -1, -1,  PIDS_CMDLINE_V      }  // strv     ( if kbd_CtrlK,   eu_CMDLINE_V  )
-   , {  -1, -1, -1,  PIDS_ENVIRON_V      }  // strv     ( if kbd_CtrlN,   eu_ENVIRON_V  )
-   , {  -1, -1, -1,  PIDS_extra          }  // s_ch     ( if Show_FOREST, eu_TREE_HID   )
-   , {  -1, -1, -1,  PIDS_extra          }  // s_int    ( if Show_FOREST, eu_TREE_LVL   )
-   , {  -1, -1, -1,  PIDS_extra          }  // s_int    ( if Show_FOREST, eu_TREE_ADD   )
+   , {  -1, -1, -1,  PIDS_CMDLINE,        NULL }  // str      ( if Show_CMDLIN, eu_CMDLINE    )
+   , {  -1, -1, -1,  PIDS_TICS_ALL_C,     NULL }  // ull_int  ( if Show_CTIMES, eu_TICS_ALL_C )
+   , {  -1, -1, -1,  PIDS_ID_FUID,        NULL }  // u_int    ( if a usrseltyp, eu_ID_FUID    )
+   , {  -1, -1, -1,  PIDS_CAPS_PERMITTED, NULL }  // str      ( if kbd_CtrlA,   eu_CAPABILITY )
+   , {  -1, -1, -1,  PIDS_CMDLINE_V,      NULL }  // strv     ( if kbd_CtrlK,   eu_CMDLINE_V  )
+   , {  -1, -1, -1,  PIDS_ENVIRON_V,      NULL }  // strv     ( if kbd_CtrlN,   eu_ENVIRON_V  )
+   , {  -1, -1, -1,  PIDS_extra,          NULL }  // s_ch     ( if Show_FOREST, eu_TREE_HID   )
+   , {  -1, -1, -1,  PIDS_extra,          NULL }  // s_int    ( if Show_FOREST, eu_TREE_LVL   )
+   , {  -1, -1, -1,  PIDS_extra,          NULL }  // s_int    ( if Show_FOREST, eu_TREE_ADD   )
  #undef A_left
  #undef A_right
 };
@@ -2253,6 +2261,16 @@ static void build_headers (void) {
          // prepare to even out column header lengths...
          if (hdrmax + w->hdrcaplen < (x = strlen(w->columnhdr))) hdrmax = x - w->hdrcaplen;
 #endif
+         // json shows every field, not just those that fit the screen
+         if (Json_mode)
+            for (i = 0; i < w->totpflgs; i++) {
+               f = w->pflgsall[i];
+               if (EU_MAXPFLGS <= f) continue;
+               ckITEM(f);
+               if (EU_CMD == f) ckCMDS(w);
+               if (EU_CPU == f) ckITEM(EU_THD);
+               if ((EU_TME == f || EU_TM2 == f) && CHKw(w, Show_CTIMES)) ckITEM(eu_TICS_ALL_C);
+            }
          // for 'busy' only processes, we'll need elapsed tics
          if (!CHKw(w, Show_IDLEPS)) ckITEM(EU_CPU);
          // with forest view mode, we'll need pid, tgid, ppid & start_time...
@@ -2852,7 +2870,7 @@ static void *tasks_refresh (void *unused) {
       what = Thread_mode ? PIDS_FETCH_THREADS_TOO : PIDS_FETCH_TASKS_ONLY;
       if (Monpidsidx) {
          what |= PIDS_SELECT_PID;
-         Pids_reap = procps_pids_select(Pids_ctx, (unsigned *)Monpids, Monpidsidx, what);
+         Pids_reap = procps_pids_select_sticky(Pids_ctx, (unsigned *)Monpids, Monpidsidx, what);
       } else
          Pids_reap = procps_pids_reap(Pids_ctx, what);
       if (!Pids_reap)
@@ -4368,7 +4386,7 @@ default_or_error:
          *       overridden -- we'll force some on and negate others in our
          *       best effort to honor the loser's (oops, user's) wishes... */
 static void parse_args (int argc, char **argv) {
-    static const char sopts[] = "Abcd:E:e:Hhin:Oo:p:SsU:u:Vw::1";
+    static const char sopts[] = "Abcd:E:e:HhiJn:Oo:p:SsU:u:Vw::1";
     static const struct option lopts[] = {
        { "apply-defaults",    no_argument,       NULL, 'A' },
        { "batch-mode",        no_argument,       NULL, 'b' },
@@ -4379,6 +4397,7 @@ static void parse_args (int argc, char **argv) {
        { "threads-show",      no_argument,       NULL, 'H' },
        { "help",              no_argument,       NULL, 'h' },
        { "idle-toggle",       no_argument,       NULL, 'i' },
+       { "json-mode",         no_argument,       NULL, 'J' },
        { "iterations",        required_argument, NULL, 'n' },
        { "list-fields",       no_argument,       NULL, 'O' },
        { "sort-override",     required_argument, NULL, 'o' },
@@ -4466,6 +4485,9 @@ static void parse_args (int argc, char **argv) {
             TOGw(Curwin, Show_IDLEPS);
             Curwin->rc.maxtasks = 0;
             break;
+         case 'J':
+            Batch = Json_mode = 1;
+            break;
          case 'n':
             if (!mkfloat(cp, &tmp, 1) || 1.0 > tmp)
                error_exit(fmtmk(N_fmt(BAD_niterate_fmt), cp));
@@ -5014,35 +5036,34 @@ static int Tree_idx;                        // frame_make resets to zero |
            ( both of these are managed under the 'keys_task()' routine ) | */
 static int *Hide_pid;                       // collapsible process array |
 static int  Hide_tot;                       // total used in above array |
+        /* these are the per frame 'pid to children' index, built by the |
+           forest_begin guy, which spares us from rescanning every task. |
+           all of the arrays (except Tree_pos) hold Seed_ppt subscripts. | */
+static int *Tree_kid;                       // a task's 1st child, or -1 |
+static int *Tree_sib;                       // its next sibling, else -1 |
+static int *Tree_end;                       // last child (for appends)  |
+static int *Tree_pos;                       // where found in Tree_ppt   |
+static int *Tree_hsh;                       // pid hash (w/ subscript+1) |
+static unsigned Tree_msk;                   // Tree_hsh entries less one |
 
         /*
          * This little recursive guy was the real forest view workhorse. |
          * He fills in the Tree_ppt array and also sets the child indent |
          * level which is stored in an 'extra' result struct as a u_int. | */
 static void forest_adds (const int self, int level) {
-  // tailored 'results stack value' extractor macros
- #define rSv(E,X) PID_VAL(E, s_int, Seed_ppt[X])
   // if xtra-procps-debug.h active, can't use PID_VAL with assignment
  #define rSv_Lvl  Tree_ppt[Tree_idx]->head[eu_TREE_LVL].result.s_int
    int i;
 
    if (Tree_idx < PIDSmaxt) {               // immunize against insanity |
       if (level > 100) level = 101;         // our arbitrary nests limit |
+      if (Tree_pos[self] < 0) Tree_pos[self] = Tree_idx;
       Tree_ppt[Tree_idx] = Seed_ppt[self];  // add this as root or child |
       rSv_Lvl = level;                      // while recording its level |
       ++Tree_idx;
-#ifdef TREE_SCANALL
-      for (i = 0; i < PIDSmaxt; i++) {
-         if (i == self) continue;
-#else
-      for (i = self + 1; i < PIDSmaxt; i++) {
-#endif
-         if (rSv(EU_PID, self) == rSv(EU_TGD, i)
-         || (rSv(EU_PID, self) == rSv(EU_PPD, i) && rSv(EU_PID, i) == rSv(EU_TGD, i)))
-            forest_adds(i, level + 1);      // got one child any others?
-      }
+      for (i = Tree_kid[self]; i >= 0; i = Tree_sib[i])
+         forest_adds(i, level + 1);         // got one child any others?
    }
- #undef rSv
  #undef rSv_Lvl
 } // end: forest_adds
 
@@ -5053,7 +5074,13 @@ static void forest_adds (const int self, int level) {
          * he'll replace that original window ppt array with a specially |
          * ordered forest view version. He'll also mark hidden children! | */
 static void forest_begin (WIN_t *q) {
+  // tailored 'results stack value' extractor macro
+ #define rSv(E,X) PID_VAL(E, s_int, Seed_ppt[X])
+  // our pid hash probe, leaving 'h' at the match or an empty slot
+ #define hshFIND(P) for (h = ((unsigned)(P) * 2654435761u) & Tree_msk; \
+   Tree_hsh[h] && rSv(EU_PID, Tree_hsh[h] - 1) != (P); h = (h + 1) & Tree_msk)
    static int hwmsav;
+   unsigned h;
    int i, j;
 
    Seed_ppt = q->ppt;                          // avoid passing pointers |
@@ -5061,6 +5088,14 @@ static void forest_begin (WIN_t *q) {
       if (hwmsav < PIDSmaxt) {                 // grow, but never shrink |
          hwmsav = PIDSmaxt;
          Tree_ppt = alloc_r(Tree_ppt, sizeof(void *) * hwmsav);
+         Tree_kid = alloc_r(Tree_kid, sizeof(int) * hwmsav);
+         Tree_sib = alloc_r(Tree_sib, sizeof(int) * hwmsav);
+         Tree_end = alloc_r(Tree_end, sizeof(int) * hwmsav);
+         Tree_pos = alloc_r(Tree_pos, sizeof(int) * hwmsav);
+         for (Tree_msk = 1024; Tree_msk < 2u * hwmsav; Tree_msk <<= 1)
+            ;
+         Tree_hsh = alloc_r(Tree_hsh, sizeof(int) * Tree_msk);
+         --Tree_msk;
       }
 
 #ifndef TREE_SCANALL
@@ -5068,6 +5103,28 @@ static void forest_begin (WIN_t *q) {
          , PIDS_TICS_BEGAN, PIDS_SORT_ASCEND)))
             error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
 #endif
+      memset(Tree_hsh, 0, sizeof(int) * (Tree_msk + 1));
+      for (i = 0; i < PIDSmaxt; i++) {
+         Tree_kid[i] = Tree_sib[i] = Tree_end[i] = Tree_pos[i] = -1;
+         hshFIND(rSv(EU_PID, i));
+         if (!Tree_hsh[h]) Tree_hsh[h] = i + 1;
+      }
+      /* a thread's parent is its task group leader, while a process has |
+         its parent process. since the children are linked in subscript |
+         order, the results are what a scan of every task would yield. | */
+      for (i = 0; i < PIDSmaxt; i++) {
+         int pid = rSv(EU_PID, i) == rSv(EU_TGD, i) ? rSv(EU_PPD, i) : rSv(EU_TGD, i);
+         hshFIND(pid);
+         if ((j = Tree_hsh[h] - 1) < 0) continue;
+#ifdef TREE_SCANALL
+         if (j == i) continue;
+#else
+         if (j >= i) continue;
+#endif
+         if (Tree_end[j] < 0) Tree_kid[j] = i;
+         else Tree_sib[Tree_end[j]] = i;
+         Tree_end[j] = i;
+      }
       for (i = 0; i < PIDSmaxt; i++) {         // avoid hidepid distorts |
          if (!PID_VAL(eu_TREE_LVL, s_int, Seed_ppt[i])) // parents lvl 0 |
             forest_adds(i, 0);                 // add parents + children |
@@ -5080,43 +5137,39 @@ static void forest_begin (WIN_t *q) {
       for (i = 0; i < Hide_tot; i++) {
 
         // if have xtra-procps-debug.h, cannot use PID_VAL w/ assignment |
-       #define rSv(E,T,X)  Tree_ppt[X]->head[E].result.T
-       #define rSv_Pid(X)  rSv(EU_PID, s_int, X)
-       #define rSv_Lvl(X)  rSv(eu_TREE_LVL, s_int, X)
-       #define rSv_Hid(X)  rSv(eu_TREE_HID, s_ch, X)
+       #define rSt(E,T,X)  Tree_ppt[X]->head[E].result.T
+       #define rSv_Lvl(X)  rSt(eu_TREE_LVL, s_int, X)
+       #define rSv_Hid(X)  rSt(eu_TREE_HID, s_ch, X)
         /* next 2 aren't needed if TREE_VCPUOFF but they cost us nothing |
            & the EU_CPU slot will now always be present (even if it's 0) | */
-       #define rSv_Add(X)  rSv(eu_TREE_ADD, u_int, X)
-       #define rSv_Cpu(X)  rSv(EU_CPU, u_int, X)
+       #define rSv_Add(X)  rSt(eu_TREE_ADD, u_int, X)
+       #define rSv_Cpu(X)  rSt(EU_CPU, u_int, X)
 
          if (Hide_pid[i] > 0) {
-            for (j = 0; j < PIDSmaxt; j++) {
-               if (rSv_Pid(j) == Hide_pid[i]) {
-                  int parent = j;
-                  int children = 0;
-                  int level = rSv_Lvl(parent);
-                  while (j+1 < PIDSmaxt && rSv_Lvl(j+1) > level) {
-                     ++j;
-                     rSv_Hid(j) = 'z';
+            hshFIND(Hide_pid[i]);
+            // if a target task disappeared prevent any further scanning |
+            if (!Tree_hsh[h] || (j = Tree_pos[Tree_hsh[h] - 1]) < 0)
+               Hide_pid[i] = -Hide_pid[i];
+            else {
+               int parent = j;
+               int children = 0;
+               int level = rSv_Lvl(parent);
+               while (j+1 < PIDSmaxt && rSv_Lvl(j+1) > level) {
+                  ++j;
+                  rSv_Hid(j) = 'z';
 #ifndef TREE_VCPUOFF
-                     rSv_Add(parent) += rSv_Cpu(j);
+                  rSv_Add(parent) += rSv_Cpu(j);
 #endif
-                     children = 1;
-                  }
-                  /* if any children found (& collapsed) mark the parent |
-                     ( when children aren't found don't negate the pid ) |
-                     ( to prevent future scans since who's to say such ) |
-                     ( tasks will not fork more children in the future ) | */
-                  if (children) rSv_Hid(parent) = 'x';
-                  // this will force a check of next Hide_pid[i], if any |
-                  j = PIDSmaxt + 1;
+                  children = 1;
                }
+               /* if any children found (& collapsed) mark the parent |
+                  ( when children aren't found don't negate the pid ) |
+                  ( to prevent future scans since who's to say such ) |
+                  ( tasks will not fork more children in the future ) | */
+               if (children) rSv_Hid(parent) = 'x';
             }
-            // if a target task disappeared prevent any further scanning |
-            if (j == PIDSmaxt) Hide_pid[i] = -Hide_pid[i];
          }
-       #undef rSv
-       #undef rSv_Pid
+       #undef rSt
        #undef rSv_Lvl
        #undef rSv_Hid
        #undef rSv_Add
@@ -5124,6 +5177,8 @@ static void forest_begin (WIN_t *q) {
       }
    } // end: !Tree_idx
    memcpy(Seed_ppt, Tree_ppt, sizeof(void *) * PIDSmaxt);
+ #undef rSv
+ #undef hshFIND
 } // end: forest_begin
 
 
@@ -5513,6 +5568,10 @@ static void find_string (int ch) {
       snprintf(Curwin->findstr, FNDBUFSIZ, "%s", str);
       Curwin->findlen = strlen(Curwin->findstr);
       found = 0;
+      // window_show may have sorted only the visible tasks (see topk)
+      if (Curwin->ordtot && !CHKw(Curwin, Show_FOREST)
+      && !(procps_pids_sort(Pids_ctx, Curwin->ppt, PIDSmaxt, Curwin->ordkey, Curwin->ordsrt)))
+         error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
    }
    if (Curwin->findstr[0]) {
       SETw(Curwin, NOPRINT_xxx);
@@ -7262,6 +7321,12 @@ static const char *task_show (const WIN_t *q, int idx) {
          case EU_IRO:        // PIDS_IO_READ_OPS
          case EU_IWB:        // PIDS_IO_WRITE_BYTES
          case EU_IWO:        // PIDS_IO_WRITE_OPS
+         case EU_VCI:        // PIDS_CTXSW_INVOL_DELTA
+         case EU_VCV:        // PIDS_CTXSW_VOL_DELTA
+         case EU_VRB:        // PIDS_IO_READ_BYTES_DELTA
+         case EU_VRO:        // PIDS_IO_READ_OPS_DELTA
+         case EU_VWB:        // PIDS_IO_WRITE_BYTES_DELTA
+         case EU_VWO:        // PIDS_IO_WRITE_OPS_DELTA
             cp = scale_num(rSv(i, ul_int), W, Jn);
             break;
    /* ul_int, scale_pcnt */
@@ -7430,17 +7495,101 @@ wrap_up:
 } // end: window_hlp
 
 
+        /*
+         * When the prior frame was sorted by this same item and order, |
+         * arrange this window's stacks as they were then, leaving any |
+         * new tasks at the end. Since that order rarely changes much |
+         * the library's sort is then spared most of its work (and a |
+         * task tied with others won't be seen hopping among them). |
+         * Otherwise the stacks are left as is. Either way, this item |
+         * and order are remembered, for the next frame's benefit. | */
+static void window_ord (WIN_t *q, enum pids_item item, enum pids_sort_order order) {
+  // tailored 'results stack value' extractor macro
+ #define rSv(X) PID_VAL(EU_PID, s_int, q->ppt[X])
+  // our pid hash probe, leaving 'h' at the match or an empty slot
+ #define hshFIND(P) for (h = ((unsigned)(P) * 2654435761u) & msk; \
+   hsh[h] && pid[hsh[h] - 1] != (P); h = (h + 1) & msk)
+   static struct pids_stack **ppt;
+   static int hwmsav, *pid, *hsh;
+   static unsigned msk;
+   unsigned h;
+   int i, j, n;
+
+   if (hwmsav < PIDSmaxt) {                    // grow, but never shrink |
+      hwmsav = PIDSmaxt;
+      ppt = alloc_r(ppt, sizeof(void *) * hwmsav);
+      pid = alloc_r(pid, sizeof(int) * hwmsav);
+      for (msk = 1024; msk < 2u * hwmsav; msk <<= 1)
+         ;
+      hsh = alloc_r(hsh, sizeof(int) * msk);
+      --msk;
+   }
+   if (q->ordtot && q->ordkey == item && q->ordsrt == order) {
+      memset(hsh, 0, sizeof(int) * (msk + 1));
+      for (i = 0; i < PIDSmaxt; i++) {
+         pid[i] = rSv(i);
+         hshFIND(pid[i]);
+         if (!hsh[h]) hsh[h] = i + 1;
+      }
+      // the survivors (in their old order), then any newcomers ...
+      for (i = n = 0; i < q->ordtot; i++) {
+         hshFIND(q->ordpid[i]);
+         if ((j = hsh[h] - 1) < 0 || !q->ppt[j]) continue;
+         ppt[n++] = q->ppt[j];
+         q->ppt[j] = NULL;
+      }
+      for (i = 0; i < PIDSmaxt; i++)
+         if (q->ppt[i]) ppt[n++] = q->ppt[i];
+      memcpy(q->ppt, ppt, sizeof(void *) * PIDSmaxt);
+   }
+   q->ordkey = item;
+   q->ordsrt = order;
+   q->ordtot = 0;
+ #undef rSv
+ #undef hshFIND
+} // end: window_ord
+
+
+        /*
+         * Sort this window's stacks by its sort field, either fully or |
+         * (when 'k' is not negative) just enough so the first 'k' are |
+         * in order, then remember that order for the next frame. | */
+static void window_sort (WIN_t *q, int k) {
+ #define sORDER  (CHKw(q, Qsrt_NORMAL) ? PIDS_SORT_DESCEND : PIDS_SORT_ASCEND)
+   enum pids_item item = Fieldstab[q->rc.sortindx].item;
+   int i;
+
+   if (item == PIDS_CMD && CHKw(q, Show_CMDLIN))
+      item = PIDS_CMDLINE;
+   else if (item == PIDS_TICS_ALL && CHKw(q, Show_CTIMES))
+      item = PIDS_TICS_ALL_C;
+   window_ord(q, item, sORDER);
+   if (0 <= k) {
+      if (!(procps_pids_topk(Pids_ctx, q->ppt, PIDSmaxt, k, item, sORDER)))
+         error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+   } else if (!(procps_pids_sort(Pids_ctx, q->ppt , PIDSmaxt, item, sORDER)))
+      error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+   if (q->ordhwm < PIDSmaxt) {
+      q->ordhwm = PIDSmaxt;
+      q->ordpid = alloc_r(q->ordpid, sizeof(int) * q->ordhwm);
+   }
+   for (i = 0; i < PIDSmaxt; i++)
+      q->ordpid[i] = PID_VAL(EU_PID, s_int, q->ppt[i]);
+   q->ordtot = PIDSmaxt;
+ #undef sORDER
+} // end: window_sort
+
+
         /*
          * Squeeze as many tasks as we can into a single window,
          * after sorting the passed proc table. */
 static int window_show (WIN_t *q, int wmax) {
- #define sORDER  CHKw(q, Qsrt_NORMAL) ? PIDS_SORT_DESCEND : PIDS_SORT_ASCEND
  /* the isBUSY macro determines if a task is 'active' --
     it returns true if some cpu was used since the last sample.
     ( actual 'running' tasks will be a subset of those selected ) */
  #define isBUSY(x)   (0 < PID_VAL(EU_CPU, u_int, (x)))
  #define winMIN(a,b) (((a) < (b)) ? (a) : (b))
-   int i, lwin, numtasks;
+   int i, k, lwin, numtasks;
 
    // Display Column Headings -- and distract 'em while we sort (maybe)
    PUFF("\n%s%s%s", q->capclr_hdr, q->columnhdr, Caps_endline);
@@ -7451,13 +7600,13 @@ static int window_show (WIN_t *q, int wmax) {
       forest_begin(q);
       if (q->focus_pid) forest_config(q);
    } else {
-      enum pids_item item = Fieldstab[q->rc.sortindx].item;
-      if (item == PIDS_CMD && CHKw(q, Show_CMDLIN))
-         item = PIDS_CMDLINE;
-      else if (item == PIDS_TICS_ALL && CHKw(q, Show_CTIMES))
-         item = PIDS_TICS_ALL_C;
-      if (!(procps_pids_sort(Pids_ctx, q->ppt , PIDSmaxt, item, sORDER)))
-         error_exit(fmtmk(N_fmt(LIB_errorpid_fmt), __LINE__, strerror(errno)));
+      /* when not scrolled, nor filtered, nor searched, every row shown
+         will be one of the first few, so only they need to be sorted */
+      k = winMIN(wmax, q->winlines + 1) - 1;
+      if (q->begtask || (q == Curwin && mkVIZyes) || !CHKw(q, Show_IDLEPS)
+      || q->usrseltyp || q->osel_tot || q->findlen)
+         k = -1;
+      window_sort(q, k);
    }
 
    if (mkVIZyes) window_hlp();
@@ -7485,11 +7634,279 @@ static int window_show (WIN_t *q, int wmax) {
       }
 
    return lwin;
- #undef sORDER
  #undef isBUSY
  #undef winMIN
 } // end: window_show
 
+/*######  JSON Output support  ###########################################*/
+
+        /*
+         * Output a string as JSON, quoted and with any quote, backslash |
+         * or control character escaped as that notation requires. | */
+static void json_str (const char *str) {
+   const char *run = str;
+
+   putchar('"');
+   for ( ; *str; str++) {
+      unsigned char c = *str;
+      if (c >= 0x20 && c != '"' && c != '\\') continue;
+      fwrite(run, 1, str - run, stdout);
+      if (c == '"' || c == '\\') printf("\\%c", c);
+      else printf("\\u%04x", c);
+      run = str + 1;
+   }
+   fwrite(run, 1, str - run, stdout);
+   putchar('"');
+} // end: json_str
+
+
+        /*
+         * Output one set of cpu percentages (the same ones sum_tics |
+         * would show) as members of a JSON object. | */
+static void json_tics (struct stat_stack *this) {
+  // tailored 'results stack value' extractor macro
+ #define rSv(E)  TIC_VAL(E, this)
+   SIC_t idl_frme, tot_frme;
+   float scale;
+
+   idl_frme = rSv(stat_IL);
+   tot_frme = rSv(stat_SUM_TOT);
+   if (1 > tot_frme) idl_frme = tot_frme = 1;
+   scale = 100.0 / (float)tot_frme;
+
+   printf("\"us\":%.2f,\"sy\":%.2f,\"ni\":%.2f,\"id\":%.2f"
+      ",\"wa\":%.2f,\"hi\":%.2f,\"si\":%.2f,\"st\":%.2f"
+      , (float)rSv(stat_US) * scale, (float)rSv(stat_SY) * scale
+      , (float)rSv(stat_NI) * scale, (float)idl_frme * scale
+      , (float)rSv(stat_IO) * scale, (float)rSv(stat_IR) * scale
+      , (float)rSv(stat_SI) * scale, (float)rSv(stat_ST) * scale);
+ #undef rSv
+} // end: json_tics
+
+
+        /*
+         * Output the summary area's information as a JSON object, with |
+         * memory in KiB and each cpu's states only if shown separately | */
+static void json_summary (void) {
+   double av1, av5, av15, up, idle;
+   int i;
+
+#ifdef THREADED_TSK
+   while (sem_wait(&Semaphore_tasks_end) == -1 && errno == EINTR)
+      ;
+#endif
+   av1 = av5 = av15 = up = idle = 0;
+   procps_loadavg(&av1, &av5, &av15);
+   procps_uptime(&up, &idle);
+   printf("\"summary\":{\"time\":%ld,\"uptime\":%.2f,\"load\":[%.2f,%.2f,%.2f]"
+      , (long)time(NULL), up, av1, av5, av15);
+   printf(",\"tasks\":{\"total\":%d,\"running\":%d,\"sleeping\":%d"
+      ",\"disk_sleep\":%d,\"stopped\":%d,\"zombie\":%d}"
+      , PIDSmaxt, Pids_reap->counts->running
+      , Pids_reap->counts->sleeping + Pids_reap->counts->other
+      , Pids_reap->counts->disk_sleep
+      , Pids_reap->counts->stopped, Pids_reap->counts->zombied);
+   if (Restrict_some) {
+      putchar('}');
+      return;
+   }
+
+#ifdef THREADED_CPU
+   while (sem_wait(&Semaphore_cpus_end) == -1 && errno == EINTR)
+      ;
+#endif
+   fputs(",\"cpu\":{", stdout);
+   json_tics(Stat_reap->summary);
+   putchar('}');
+   if (!CHKw(Curwin, View_CPUSUM)) {
+      fputs(",\"cpus\":[", stdout);
+      for (i = 0; i < Cpu_cnt; i++) {
+         printf("%s{\"id\":%d,", i ? "," : "", CPU_VAL(stat_ID, i));
+         json_tics(Stat_reap->cpus->stacks[i]);
+         putchar('}');
+      }
+      putchar(']');
+   }
+
+#ifdef THREADED_MEM
+   while (sem_wait(&Semaphore_memory_end) == -1 && errno == EINTR)
+      ;
+#endif
+   printf(",\"memory\":{\"total\":%lu,\"free\":%lu,\"used\":%lu"
+      ",\"buff_cache\":%lu,\"avail\":%lu}"
+      , MEM_VAL(mem_TOT), MEM_VAL(mem_FRE), MEM_VAL(mem_USE)
+      , MEM_VAL(mem_BUF) + MEM_VAL(mem_QUE), MEM_VAL(mem_AVL));
+   printf(",\"swap\":{\"total\":%lu,\"free\":%lu,\"used\":%lu}}"
+      , MEM_VAL(swp_TOT), MEM_VAL(swp_FRE), MEM_VAL(swp_USE));
+} // end: json_summary
+
+
+        /*
+         * Output a single task's fields as a JSON object, keyed by the |
+         * field names and with raw values: no scaling, justification, |
+         * truncation or column widths (memory in KiB, times in secs). | */
+static void json_task (const WIN_t *q, int idx) {
+  // a tailored 'results stack value' extractor macro
+ #define rSv(E,T)  PID_VAL(E, T, p)
+   struct pids_stack *p = q->ppt[idx];
+   const char *sep = "";
+   int x;
+
+   putchar('{');
+   for (x = 0; x < q->totpflgs; x++) {
+      FLG_t i = q->pflgsall[x];
+
+      if (i >= EU_MAXPFLGS) continue;  // one of those column highlighters
+      printf("%s", sep);
+      json_str(Fieldstab[i].key);
+      putchar(':');
+      sep = ",";
+
+      switch (i) {
+         case EU_STA:        // PIDS_STATE
+            printf("\"%c\"", rSv(EU_STA, s_ch));
+            break;
+         case EU_AGI:        // PIDS_AUTOGRP_ID
+         case EU_AGN:        // PIDS_AUTOGRP_NICE
+         case EU_CPN:        // PIDS_PROCESSOR
+         case EU_FDS:        // PIDS_OPEN_FILES
+         case EU_FV1:        // PIDS_FLT_MAJ_DELTA
+         case EU_FV2:        // PIDS_FLT_MIN_DELTA
+         case EU_LID:        // PIDS_ID_LOGIN
+         case EU_NCE:        // PIDS_NICE
+         case EU_NMA:        // PIDS_PROCESSOR_NODE
+         case EU_OOA:        // PIDS_OOM_ADJ
+         case EU_OOM:        // PIDS_OOM_SCORE
+         case EU_PGD:        // PIDS_ID_PGRP
+         case EU_PID:        // PIDS_ID_PID
+         case EU_PPD:        // PIDS_ID_PPID
+         case EU_PRI:        // PIDS_PRIORITY
+         case EU_SID:        // PIDS_ID_SESSION
+         case EU_TGD:        // PIDS_ID_TGID
+         case EU_THD:        // PIDS_NLWP
+         case EU_TPG:        // PIDS_ID_TPGID
+            printf("%d", rSv(i, s_int));
+            break;
+         case EU_CPU:        // PIDS_TICS_ALL_DELTA
+         {  float u = (float)rSv(EU_CPU, u_int) * Frame_etscale;
+            int n = rSv(EU_THD, s_int);
+            if (u > 100.0 * n) u = 100.0 * n;
+            printf("%.2f", u);
+         }
+            break;
+         case EU_CUU:        // PIDS_UTILIZATION
+         case EU_CUC:        // PIDS_UTILIZATION_C
+            printf("%.2f", rSv(i, real));
+            break;
+         case EU_GID:        // PIDS_ID_EGID
+         case EU_UED:        // PIDS_ID_EUID
+         case EU_URD:        // PIDS_ID_RUID
+         case EU_USD:        // PIDS_ID_SUID
+            printf("%u", rSv(i, u_int));
+            break;
+         case EU_COD:        // PIDS_MEM_CODE
+         case EU_DAT:        // PIDS_MEM_DATA
+         case EU_DRT:        // PIDS_noop, really # pgs, but always 0 since 2.6
+         case EU_FL1:        // PIDS_FLT_MAJ
+         case EU_FL2:        // PIDS_FLT_MIN
+         case EU_FLG:        // PIDS_FLAGS
+         case EU_IRB:        // PIDS_IO_READ_BYTES
+         case EU_IRO:        // PIDS_IO_READ_OPS
+         case EU_IWB:        // PIDS_IO_WRITE_BYTES
+         case EU_IWO:        // PIDS_IO_WRITE_OPS
+         case EU_NS1:        // PIDS_NS_IPC
+         case EU_NS2:        // PIDS_NS_MNT
+         case EU_NS3:        // PIDS_NS_NET
+         case EU_NS4:        // PIDS_NS_PID
+         case EU_NS5:        // PIDS_NS_USER
+         case EU_NS6:        // PIDS_NS_UTS
+         case EU_NS7:        // PIDS_NS_CGROUP
+         case EU_NS8:        // PIDS_NS_TIME
+         case EU_PZA:        // PIDS_SMAP_PSS_ANON
+         case EU_PZF:        // PIDS_SMAP_PSS_FILE
+         case EU_PZS:        // PIDS_SMAP_PSS_SHMEM
+         case EU_PSS:        // PIDS_SMAP_PSS
+         case EU_RES:        // PIDS_MEM_RES
+         case EU_RSS:        // PIDS_SMAP_RSS
+         case EU_RZA:        // PIDS_VM_RSS_ANON
+         case EU_RZF:        // PIDS_VM_RSS_FILE
+         case EU_RZL:        // PIDS_VM_RSS_LOCKED
+         case EU_RZS:        // PIDS_VM_RSS_SHARED
+         case EU_SHR:        // PIDS_MEM_SHR
+         case EU_SWP:        // PIDS_VM_SWAP
+         case EU_USE:        // PIDS_VM_USED
+         case EU_USS:        // PIDS_SMAP_PRV_TOTAL
+         case EU_VCI:        // PIDS_CTXSW_INVOL_DELTA
+         case EU_VCV:        // PIDS_CTXSW_VOL_DELTA
+         case EU_VRB:        // PIDS_IO_READ_BYTES_DELTA
+         case EU_VRO:        // PIDS_IO_READ_OPS_DELTA
+         case EU_VRT:        // PIDS_MEM_VIRT
+         case EU_VWB:        // PIDS_IO_WRITE_BYTES_DELTA
+         case EU_VWO:        // PIDS_IO_WRITE_OPS_DELTA
+            printf("%lu", rSv(i, ul_int));
+            break;
+         case EU_MEM:        // derive from PIDS_MEM_RES
+            if (Restrict_some) fputs("null", stdout);
+            else printf("%.2f", (float)rSv(EU_MEM, ul_int) * 100 / MEM_VAL(mem_TOT));
+            break;
+         case EU_TM2:        // PIDS_TICS_ALL
+         case EU_TME:        // PIDS_TICS_ALL
+            printf("%.2f", (double)(CHKw(q, Show_CTIMES)
+               ? rSv(eu_TICS_ALL_C, ull_int) : rSv(i, ull_int)) / Hertz);
+            break;
+         case EU_TM3:        // PIDS_TICS_BEGAN
+            printf("%.2f", (double)rSv(EU_TM3, ull_int) / Hertz);
+            break;
+         case EU_TM4:        // PIDS_TIME_ELAPSED
+            printf("%.2f", rSv(EU_TM4, real));
+            break;
+         case EU_CMD:        // PIDS_CMD or PIDS_CMDLINE
+            json_str(CHKw(q, Show_CMDLIN) ? rSv(eu_CMDLINE, str) : rSv(EU_CMD, str));
+            break;
+         default:            // all the rest are strings
+            json_str(rSv(i, str));
+            break;
+      } // end: switch 'procflag'
+   } // end: for 'maxpflgs'
+   putchar('}');
+ #undef rSv
+} // end: json_task
+
+
+        /*
+         * Output an entire frame as a single line of JSON, in place of |
+         * the usual summary_show plus window_show (for Curwin only). | */
+static void json_frame (void) {
+ // the isBUSY macro is the same as window_show's
+ #define isBUSY(x)   (0 < PID_VAL(EU_CPU, u_int, (x)))
+   WIN_t *q = Curwin;
+   int i, n, max;
+
+   putchar('{');
+   json_summary();
+   fputs(",\"tasks\":[", stdout);
+
+   max = q->rc.maxtasks ? q->rc.maxtasks : INT_MAX;
+   // as with window_show, any filtering means the entire sort is needed
+   if (PIDSmaxt)
+      window_sort(q, CHKw(q, Show_IDLEPS) && !q->usrseltyp && !q->osel_tot
+         && q->rc.maxtasks ? q->rc.maxtasks : -1);
+   /* the 'other' filters match what task_show would display, so we'll let
+      him judge those (while printing nothing), just like find_string does */
+   if (q->osel_tot) SETw(q, NOPRINT_xxx);
+   for (i = n = 0; i < PIDSmaxt && n < max; i++) {
+      if (!CHKw(q, Show_IDLEPS) && !isBUSY(q->ppt[i])) continue;
+      if (!wins_usrselect(q, i)) continue;
+      if (q->osel_tot && !*task_show(q, i)) continue;
+      if (n++) putchar(',');
+      json_task(q, i);
+   }
+   OFFw(q, NOPRINT_xxx);
+   fputs("]}\n", stdout);
+   fflush(stdout);
+ #undef isBUSY
+} // end: json_frame
+
 /*######  Entry point plus two  ##########################################*/
 
         /*
@@ -7569,6 +7986,11 @@ static void frame_make (void) {
 #endif
    }
 
+   if (Json_mode) {
+      json_frame();
+      return;
+   }
+
    if (!Batch) putp(Cap_home);
 
    Tree_idx = Pseudo_row = Msg_row = scrlins = 0;
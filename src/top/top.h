@@ -245,6 +245,7 @@ enum pflag {
    EU_NS7, EU_NS8,
    EU_CLS, EU_DKR,
    EU_FDS,
+   EU_VRB, EU_VRO, EU_VWB, EU_VWO, EU_VCV, EU_VCI,
 #ifdef USE_X_COLHDR
    // not really pflags, used with tbl indexing
    EU_MAXPFLGS
@@ -420,6 +421,11 @@ typedef struct WIN_t {
    int    focus_lvl;                   // the indentation level of parent task
 #endif
    struct pids_stack **ppt;            // this window's stacks ptr array
+   int   *ordpid,                      // pids as sorted in the prior frame
+          ordtot,                      // total used in the above array
+          ordhwm,                      // total allocated for that array
+          ordkey,                      // the item that sorted those pids
+          ordsrt;                      // and in which order (+1 or -1)
    struct WIN_t *next,                 // next window in window stack
                 *prev;                 // prior window in window stack
 } WIN_t;
@@ -827,7 +833,15 @@ typedef struct WIN_t {
 //atic void          summary_show (void);
 //atic const char   *task_show (const WIN_t *q, int idx);
 //atic void          window_hlp (void);
+//atic void          window_ord (WIN_t *q, enum pids_item item, enum pids_sort_order order);
+//atic void          window_sort (WIN_t *q, int k);
 //atic int           window_show (WIN_t *q, int wmax);
+/*------  JSON Output support  -------------------------------------------*/
+//atic void          json_str (const char *str);
+//atic void          json_tics (struct stat_stack *this);
+//atic void          json_summary (void);
+//atic void          json_task (const WIN_t *q, int idx);
+//atic void          json_frame (void);
 /*------  Entry point plus two  ------------------------------------------*/
 //atic void          frame_hlp (int wix, int max);
 //atic void          frame_make (void);
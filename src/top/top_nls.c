@@ -378,6 +378,24 @@ static void build_two_nlstabs (void) {
 /* Translation Hint: maximum 'nFD' = 3 */
    Head_nlstab[EU_FDS] = _("nFD");
    Desc_nlstab[EU_FDS] = _("Number of Open Files");
+/* Translation Hint: maximum 'vioR' = 6 */
+   Head_nlstab[EU_VRB] = _("vioR");
+   Desc_nlstab[EU_VRB] = _("I/O Bytes Read delta");
+/* Translation Hint: maximum 'vRop' = 5 */
+   Head_nlstab[EU_VRO] = _("vRop");
+   Desc_nlstab[EU_VRO] = _("I/O Read Ops delta");
+/* Translation Hint: maximum 'vioW' = 6 */
+   Head_nlstab[EU_VWB] = _("vioW");
+   Desc_nlstab[EU_VWB] = _("I/O Bytes Wrtn delta");
+/* Translation Hint: maximum 'vWop' = 5 */
+   Head_nlstab[EU_VWO] = _("vWop");
+   Desc_nlstab[EU_VWO] = _("I/O Write Ops delta");
+/* Translation Hint: maximum 'vVcs' = 4 */
+   Head_nlstab[EU_VCV] = _("vVcs");
+   Desc_nlstab[EU_VCV] = _("Volun Switches delta");
+/* Translation Hint: maximum 'vIcs' = 4 */
+   Head_nlstab[EU_VCI] = _("vIcs");
+   Desc_nlstab[EU_VCI] = _("Invol Switches delta");
 }
 
 
@@ -418,6 +436,7 @@ static void build_norm_nlstab (void) {
       " -e, --scale-task-mem =SCALE     set mem with: k,m,g,t,p for SCALE\n"
       " -H, --threads-show              show tasks plus all their threads\n"
       " -i, --idle-toggle               reverse last remembered 'i' state\n"
+      " -J, --json-mode                 batch mode, with each frame as json\n"
       " -n, --iterations =NUMBER        exit on maximum iterations NUMBER\n"
       " -O, --list-fields               output all field names, then exit\n"
       " -o, --sort-override =FIELD      force sorting on this named FIELD\n"